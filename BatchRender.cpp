@@ -0,0 +1,365 @@
+//==============================================================================
+// Headless batch renderer: streams audio files through SSLCompressorAudioProcessor
+// without an editor, one file per thread-pool job.
+//
+// Built by CMakeLists.txt as its own console application target from this file
+// plus the plugin sources (PluginProcessor.cpp, PluginEditor.cpp,
+// Instrumentation.cpp) and the same JUCE modules, with JucePlugin_Name defined.
+// It is not part of the plugin target.
+//
+//   BatchRender [options] <input files...>
+//     --output <dir>        where rendered files go (default: next to each input)
+//     --state <file>        processor state saved from the plugin, applied first
+//     --preset <name>       factory preset, applied after the state
+//     --set <id>=<value>    parameter in real-world units, e.g. --set threshold=-18 (repeatable)
+//     --threads <n>         worker threads (default: number of cores)
+//     --block <n>           samples per processBlock call (default 1024)
+//
+// Rendered files are named after their input with an "_ssl" suffix. An input is
+// never overwritten, and inputs that would render to the same file are refused
+// before anything is written.
+//
+// Input is read in chunks, through a memory-mapped reader for WAV and AIFF and
+// a regular streaming reader otherwise. Output keeps the input's format, rate,
+// channel count and bit depth, and is aligned to the input: the processor's
+// latency is trimmed from the start and flushed at the end.
+//
+// Throughput is reported per file and in total as samples/sec/core, where a
+// sample is one sample frame (all channels) and the time is spent in the job.
+// Builds with SSL_INSTRUMENTATION also print each file's block timing and
+// real-time safety counts, and fail when a block allocated or locked.
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <iostream>
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::File outputDirectory;
+        juce::MemoryBlock state;
+        juce::String preset;
+        juce::StringPairArray parameterValues;
+        int blockSize = 1024;
+    };
+
+    struct RenderResult
+    {
+        juce::String error;
+        juce::int64 numFrames = 0;
+        double seconds = 0.0;
+        SSLBlockStats blockStats;
+        bool hasBlockStats = false;
+    };
+
+    //==============================================================================
+    std::unique_ptr<juce::AudioFormatReader> createReader (juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        // Memory-mapped readers avoid copying through a stream buffer for the formats that support it
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped;
+
+        if (file.hasFileExtension ("wav;wave"))
+            mapped.reset (juce::WavAudioFormat().createMemoryMappedReader (file));
+        else if (file.hasFileExtension ("aif;aiff"))
+            mapped.reset (juce::AiffAudioFormat().createMemoryMappedReader (file));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped;
+
+        return std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file));
+    }
+
+    juce::File getOutputFile (const juce::File& input, const RenderSettings& settings)
+    {
+        // The suffix stays with --output too, so an output directory that holds the inputs keeps them
+        const auto directory = settings.outputDirectory != juce::File() ? settings.outputDirectory : input.getParentDirectory();
+        return directory.getChildFile (input.getFileNameWithoutExtension() + "_ssl" + input.getFileExtension());
+    }
+
+    bool applySettings (SSLCompressorAudioProcessor& processor, const RenderSettings& settings, juce::String& error)
+    {
+        if (settings.state.getSize() > 0)
+            processor.setStateInformation (settings.state.getData(), (int) settings.state.getSize());
+
+        if (settings.preset.isNotEmpty())
+        {
+            int program = 0;
+
+            while (program < processor.getNumPrograms() && ! processor.getProgramName (program).equalsIgnoreCase (settings.preset))
+                ++program;
+
+            if (program == processor.getNumPrograms())
+            {
+                error = "unknown preset '" + settings.preset + "'";
+                return false;
+            }
+
+            processor.setCurrentProgram (program);
+        }
+
+        for (auto& parameterID : settings.parameterValues.getAllKeys())
+        {
+            auto* parameter = processor.parameters.getParameter (parameterID);
+
+            if (parameter == nullptr)
+            {
+                error = "unknown parameter '" + parameterID + "'";
+                return false;
+            }
+
+            const float value = settings.parameterValues[parameterID].getFloatValue();
+            parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    RenderResult renderFile (const juce::File& input, const RenderSettings& settings)
+    {
+        RenderResult result;
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        auto reader = createReader (formats, input);
+
+        if (reader == nullptr)
+        {
+            result.error = "can't read " + input.getFullPathName();
+            return result;
+        }
+
+        const int numChannels = (int) reader->numChannels;
+        const double sampleRate = reader->sampleRate;
+        const juce::int64 length = reader->lengthInSamples;
+
+        SSLCompressorAudioProcessor processor;
+
+        // Match the bus to the file, e.g. 5.1 or 7.1.4 stems
+        juce::AudioProcessor::BusesLayout layout;
+        const auto channelSet = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+        layout.inputBuses.add (channelSet.isDisabled() ? juce::AudioChannelSet::discreteChannels (numChannels) : channelSet);
+        layout.outputBuses.add (layout.inputBuses.getReference (0));
+
+        if (! processor.setBusesLayout (layout))
+        {
+            result.error = "unsupported channel count " + juce::String (numChannels) + " in " + input.getFullPathName();
+            return result;
+        }
+
+        if (! applySettings (processor, settings, result.error))
+            return result;
+
+        processor.setNonRealtime (true);
+        processor.setRateAndBufferSizeDetails (sampleRate, settings.blockSize);
+        processor.prepareToPlay (sampleRate, settings.blockSize);
+
+        const auto outputFile = getOutputFile (input, settings);
+        auto* format = formats.findFormatForFileExtension (outputFile.getFileExtension());
+        outputFile.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream (outputFile.createOutputStream());
+
+        if (format == nullptr || stream == nullptr)
+        {
+            result.error = "can't write " + outputFile.getFullPathName();
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), sampleRate, (unsigned int) numChannels,
+                                                                                  (int) reader->bitsPerSample, reader->metadataValues, 0));
+
+        if (writer == nullptr)
+        {
+            result.error = "can't create a writer for " + outputFile.getFullPathName();
+            return result;
+        }
+
+        stream.release();  // now owned by the writer
+
+        juce::AudioBuffer<float> buffer (numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        // Render the file plus the latency worth of silence, then drop the first 'latency' samples
+        const juce::int64 latency = processor.getLatencySamples();
+        juce::int64 toSkip = latency;
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (juce::int64 position = 0; position < length + latency; position += settings.blockSize)
+        {
+            const int numSamples = (int) juce::jmin ((juce::int64) settings.blockSize, length + latency - position);
+            buffer.setSize (numChannels, numSamples, false, false, true);
+
+            // Reading past the end fills with zeros, which flushes the lookahead and oversampling delay
+            reader->read (&buffer, 0, numSamples, position, true, true);
+            processor.processBlock (buffer, midi);
+
+            const int skip = (int) juce::jmin (toSkip, (juce::int64) numSamples);
+            toSkip -= skip;
+
+            if (skip < numSamples)
+                writer->writeFromAudioSampleBuffer (buffer, skip, numSamples - skip);
+        }
+
+        result.seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+        result.numFrames = length;
+        result.hasBlockStats = processor.getBlockStats (result.blockStats);
+
+        processor.releaseResources();
+        return result;
+    }
+
+    //==============================================================================
+    void printUsage()
+    {
+        std::cout << "usage: BatchRender [--output <dir>] [--state <file>] [--preset <name>] [--set <id>=<value>]... "
+                     "[--threads <n>] [--block <n>] <input files...>" << std::endl;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderSettings settings;
+    juce::Array<juce::File> inputs;
+    int numThreads = juce::SystemStats::getNumCpus();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--output" && hasValue)
+        {
+            settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+            settings.outputDirectory.createDirectory();
+        }
+        else if (arg == "--state" && hasValue)
+        {
+            const auto stateFile = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+
+            if (! stateFile.loadFileAsData (settings.state))
+            {
+                std::cerr << "can't read state file " << stateFile.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--preset" && hasValue)
+        {
+            settings.preset = argv[++i];
+        }
+        else if (arg == "--set" && hasValue)
+        {
+            const juce::String assignment (argv[++i]);
+            settings.parameterValues.set (assignment.upToFirstOccurrenceOf ("=", false, false).trim(),
+                                          assignment.fromFirstOccurrenceOf ("=", false, false).trim());
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            numThreads = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+        }
+        else if (arg == "--block" && hasValue)
+        {
+            settings.blockSize = juce::jmax (16, juce::String (argv[++i]).getIntValue());
+        }
+        else if (arg.startsWith ("--"))
+        {
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            inputs.add (juce::File::getCurrentWorkingDirectory().getChildFile (arg));
+        }
+    }
+
+    if (inputs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Rendering deletes the output first, so it must never be an input or another input's output
+    juce::Array<juce::File> outputs;
+
+    for (auto& input : inputs)
+    {
+        const auto outputFile = getOutputFile (input, settings);
+
+        if (inputs.contains (outputFile))
+        {
+            std::cerr << "error: " << input.getFullPathName() << " would overwrite the input " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        if (outputs.contains (outputFile))
+        {
+            std::cerr << "error: more than one input renders to " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        outputs.add (outputFile);
+    }
+
+    // Files are independent, so each job owns its processor instance and nothing is shared
+    std::vector<RenderResult> results ((size_t) inputs.size());
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool pool (numThreads);
+
+        for (int i = 0; i < inputs.size(); ++i)
+            pool.addJob ([&results, &inputs, &settings, i] { results[(size_t) i] = renderFile (inputs[i], settings); });
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep (20);
+    }
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    juce::int64 totalFrames = 0;
+    double totalSeconds = 0.0;
+    int numFailed = 0;
+
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        const auto& result = results[(size_t) i];
+
+        if (result.error.isNotEmpty())
+        {
+            std::cerr << "error: " << result.error << std::endl;
+            ++numFailed;
+            continue;
+        }
+
+        totalFrames += result.numFrames;
+        totalSeconds += result.seconds;
+
+        std::cout << inputs[i].getFileName() << ": " << result.numFrames << " samples in "
+                  << juce::String (result.seconds, 3) << " s, "
+                  << juce::String (result.numFrames / juce::jmax (1.0e-9, result.seconds), 0) << " samples/sec" << std::endl;
+
+        if (result.hasBlockStats)
+        {
+            std::cout << "  " << result.blockStats.toString() << std::endl;
+
+            if (! result.blockStats.isRealtimeSafe())
+            {
+                std::cerr << "error: " << inputs[i].getFileName() << " allocated or locked in processBlock" << std::endl;
+                ++numFailed;
+            }
+        }
+    }
+
+    std::cout << "total: " << totalFrames << " samples, " << inputs.size() - numFailed << " files, "
+              << numThreads << " threads, " << juce::String (wallSeconds, 3) << " s wall" << std::endl
+              << "throughput: " << juce::String (totalFrames / juce::jmax (1.0e-9, totalSeconds), 0) << " samples/sec/core, "
+              << juce::String (totalFrames / juce::jmax (1.0e-9, wallSeconds), 0) << " samples/sec overall" << std::endl;
+
+    return numFailed > 0 ? 1 : 0;
+}
\ No newline at end of file
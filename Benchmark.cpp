@@ -0,0 +1,251 @@
+//==============================================================================
+// Microbenchmark and regression check for SSLCompressorAudioProcessor::processBlock.
+//
+// Built by CMakeLists.txt as its own console application target from this file
+// plus the plugin sources and the same JUCE modules, like BatchRender.cpp.
+//
+// In builds with SSL_INSTRUMENTATION every timed configuration also reports its
+// per-block timing and real-time safety counts, and a block that allocated or
+// locked fails the run like a regression does.
+//
+//   Benchmark [options]
+//     --full                 time the full cross product instead of one axis at a time
+//     --seconds <s>          audio rendered per timing run (default 2)
+//     --baseline <file>      results baseline (default benchmark_baseline.txt)
+//     --update-baseline      write the measured results as the new baseline
+//     --threshold <ratio>    allowed slowdown against the baseline (default 0.1 = 10 %)
+//     --golden <dir>         reference renders (default golden)
+//     --update-golden        record new reference renders instead of checking them
+//
+// Timing: each configuration renders a deterministic test signal several times
+// and keeps the fastest run. Costs are per channel sample: ns/sample from the
+// high resolution clock, cycles/sample from the time stamp counter where the
+// CPU has one. The default sweep varies one axis at a time around stereo,
+// 48 kHz, 512-sample blocks and static parameters, and runs every detector
+// mode, every multiband band count, the saturation stage and auto release;
+// --full runs every combination.
+//
+// Correctness: every detector mode, band count, saturation mode, auto release
+// mode, precision tier, lookahead and oversampling setting is rendered at
+// 48 kHz stereo and compared against a reference render in the golden
+// directory. Settings the baseline processor also had (peak, feed-forward, hard
+// knee, max link, full band, no drive, lookahead or oversampling) in any
+// precision tier are compared against the baseline processor's own render;
+// the others against references recorded by a known good build with
+// --update-golden.
+//
+// golden_baseline.sh builds GoldenReference.cpp against the baseline commit and
+// writes its golden renders plus a benchmark_baseline.txt of its timings, so
+// both checks start from the original scalar path.
+//
+// The exit code is non-zero when a golden check fails or any configuration is
+// slower than its baseline by more than the threshold.
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Benchmark.h"
+
+#include <iostream>
+
+namespace
+{
+    using namespace SSLBenchmark;
+
+    struct BenchmarkResult : Measurement
+    {
+        SSLBlockStats blockStats;       // over the timed runs, instrumented builds only
+        bool hasBlockStats = false;
+    };
+
+    std::unique_ptr<SSLCompressorAudioProcessor> createProcessor (const Configuration& config)
+    {
+        auto processor = std::make_unique<SSLCompressorAudioProcessor>();
+
+        if (! setLayout (*processor, config.numChannels))
+            return nullptr;
+
+        setCommonParameters (*processor);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_DETECTION, (float) config.detection);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_TOPOLOGY, (float) config.topology);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_KNEE, config.kneeDb);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_STEREO_LINK, (float) config.link);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_BANDS, (float) config.bands);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_DRIVE, config.drive);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_PRECISION, (float) config.precision);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_LOOKAHEAD, config.lookaheadMs);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_OVERSAMPLING, (float) config.oversampling);
+        setParameter (*processor, SSLCompressorAudioProcessor::PARAM_OVERSAMPLING_FILTER, (float) config.oversamplingFilter);
+
+        if (config.autoRelease)
+            setParameter (*processor, SSLCompressorAudioProcessor::PARAM_RELEASE, SSLCompressorAudioProcessor::autoReleaseMs);
+
+        processor->setRateAndBufferSizeDetails (config.sampleRate, config.blockSize);
+        processor->prepareToPlay (config.sampleRate, config.blockSize);
+        return processor;
+    }
+
+    BenchmarkResult measure (const Configuration& config, double seconds)
+    {
+        auto processor = createProcessor (config);
+
+        if (processor == nullptr)
+            return {};
+
+        // Only the timed runs count towards the block stats
+        BenchmarkResult result;
+        static_cast<Measurement&> (result) = SSLBenchmark::measure (*processor, config, seconds, [&processor] { processor->resetBlockStats(); });
+        result.hasBlockStats = processor->getBlockStats (result.blockStats);
+        return result;
+    }
+
+    //==============================================================================
+    // Against the baseline render the approximate dB conversions add their error; the fast tier
+    // is off by up to about 5e-3 dB, which is 5e-4 of a full-scale sample
+    float getTolerance (const Configuration& config)
+    {
+        return config.hasBaselineEquivalent() && config.precision == 2 ? 1.0e-3f : 1.0e-4f;
+    }
+
+    // Returns false when the render doesn't match (or no reference exists and we aren't writing one).
+    // Configurations the baseline processor could render are checked against its render, which only
+    // golden_baseline.sh writes; the others against a reference recorded with --update-golden.
+    bool checkGolden (const Configuration& config, const juce::File& directory, bool update)
+    {
+        const bool againstBaseline = config.hasBaselineEquivalent();
+        auto processor = createProcessor (config);
+        const auto buffer = renderGolden (*processor, config);
+        const auto file = directory.getChildFile ((againstBaseline ? config.getBaselineName() : config.getName()) + ".raw");
+
+        if (update && ! againstBaseline)
+            return writeRender (file, buffer);
+
+        juce::MemoryBlock reference;
+
+        if (! file.loadFileAsData (reference) || reference.getSize() != sizeof (float) * (size_t) (buffer.getNumChannels() * buffer.getNumSamples()))
+        {
+            std::cerr << "golden: no usable reference " << file.getFullPathName()
+                      << (againstBaseline ? " (render it with golden_baseline.sh)" : " (run with --update-golden)") << std::endl;
+            return false;
+        }
+
+        const auto* expected = static_cast<const float*> (reference.getData());
+        float maxError = 0.0f;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const auto* data = buffer.getReadPointer (channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                maxError = juce::jmax (maxError, std::abs (data[i] - *expected++));
+        }
+
+        const bool ok = maxError <= getTolerance (config);
+        std::cout << "golden " << config.getName() << (againstBaseline ? " vs baseline" : "")
+                  << ": max error " << maxError << (ok ? "" : "  FAILED") << std::endl;
+        return ok;
+    }
+
+    //==============================================================================
+    juce::StringPairArray loadBaseline (const juce::File& file)
+    {
+        juce::StringPairArray baseline;
+        juce::StringArray lines;
+        lines.addLines (file.loadFileAsString());
+
+        for (auto& line : lines)
+        {
+            auto tokens = juce::StringArray::fromTokens (line, false);
+
+            if (tokens.size() >= 2 && ! line.startsWith ("#"))
+                baseline.set (tokens[0], tokens[1]);
+        }
+
+        return baseline;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool full = false, updateBaseline = false, updateGolden = false;
+    double seconds = 2.0, threshold = 0.1;
+    auto baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile ("benchmark_baseline.txt");
+    auto goldenDirectory = juce::File::getCurrentWorkingDirectory().getChildFile ("golden");
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--full")                             full = true;
+        else if (arg == "--update-baseline")             updateBaseline = true;
+        else if (arg == "--update-golden")               updateGolden = true;
+        else if (arg == "--seconds" && hasValue)         seconds = juce::jmax (0.1, juce::String (argv[++i]).getDoubleValue());
+        else if (arg == "--threshold" && hasValue)       threshold = juce::String (argv[++i]).getDoubleValue();
+        else if (arg == "--baseline" && hasValue)        baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else if (arg == "--golden" && hasValue)          goldenDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else
+        {
+            std::cout << "usage: Benchmark [--full] [--seconds <s>] [--baseline <file>] [--update-baseline] "
+                         "[--threshold <ratio>] [--golden <dir>] [--update-golden]" << std::endl;
+            return 1;
+        }
+    }
+
+    int numFailures = 0;
+
+    // Correctness first: a fast wrong kernel is not an improvement
+    for (auto& config : getGoldenConfigurations())
+        if (! checkGolden (config, goldenDirectory, updateGolden))
+            ++numFailures;
+
+    const auto baseline = loadBaseline (baselineFile);
+    juce::String results ("# name ns/sample cycles/sample\n");
+
+    for (auto& config : getTimingConfigurations (full))
+    {
+        const auto name = config.getName();
+        const auto measurement = measure (config, seconds);
+        juce::String line = name + " " + juce::String (measurement.nsPerSample, 3) + " " + juce::String (measurement.cyclesPerSample, 2);
+
+        if (baseline.containsKey (name))
+        {
+            const double reference = baseline[name].getDoubleValue();
+            const double change = reference > 0.0 ? measurement.nsPerSample / reference - 1.0 : 0.0;
+            line << "  (" << (change >= 0.0 ? "+" : "") << juce::String (change * 100.0, 1) << " %)";
+
+            if (! updateBaseline && change > threshold)
+            {
+                line << "  REGRESSION";
+                ++numFailures;
+            }
+        }
+
+        if (measurement.hasBlockStats)
+        {
+            line << "\n    " << measurement.blockStats.toString();
+
+            if (! measurement.blockStats.isRealtimeSafe())
+            {
+                line << "  NOT REAL-TIME SAFE";
+                ++numFailures;
+            }
+        }
+
+        std::cout << line << std::endl;
+        results << name << " " << juce::String (measurement.nsPerSample, 3) << " " << juce::String (measurement.cyclesPerSample, 2) << "\n";
+    }
+
+    if (updateBaseline && ! baselineFile.replaceWithText (results))
+    {
+        std::cerr << "can't write " << baselineFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    if (numFailures > 0)
+        std::cerr << numFailures << " check(s) failed" << std::endl;
+
+    return numFailures > 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+//==============================================================================
+// What Benchmark.cpp and GoldenReference.cpp share: the configurations, the test
+// signal, the render loop and the timing. GoldenReference is built against the
+// processor of the baseline commit, so nothing here uses more than the
+// juce::AudioProcessor interface and parameter IDs the baseline already had.
+namespace SSLBenchmark
+{
+    struct Configuration
+    {
+        int blockSize = 512;
+        int numChannels = 2;
+        double sampleRate = 48000.0;
+        bool automated = false;
+        int detection = 0, topology = 0, link = 0;
+        float kneeDb = 0.0f;
+        int bands = 0;   // index of the Bands choice, 0 is full band
+        float drive = 0.0f;
+        bool autoRelease = false;
+        int precision = 1;   // index of the Precision choice, 1 is the default high tier
+        float lookaheadMs = 0.0f;
+        int oversampling = 0, oversamplingFilter = 0;
+
+        juce::String getName() const
+        {
+            return "block" + juce::String (blockSize)
+                 + "_ch" + juce::String (numChannels)
+                 + "_sr" + juce::String ((int) sampleRate)
+                 + (automated ? "_auto" : "_static")
+                 + "_det" + juce::String (detection)
+                 + "_top" + juce::String (topology)
+                 + "_knee" + juce::String ((int) kneeDb)
+                 + "_link" + juce::String (link)
+                 + (bands > 0 ? "_bands" + juce::String (bands + 1) : juce::String())
+                 + (drive > 0.0f ? "_drive" + juce::String ((int) drive) : juce::String())
+                 + (autoRelease ? "_autorelease" : "")
+                 + (precision != 1 ? "_prec" + juce::String (precision) : juce::String())
+                 + (lookaheadMs > 0.0f ? "_la" + juce::String ((int) lookaheadMs) : juce::String())
+                 + (oversampling > 0 ? "_os" + juce::String (1 << oversampling) + (oversamplingFilter > 0 ? "fir" : "")
+                                     : juce::String());
+        }
+
+        // Peak, feed-forward, hard knee, max link, full band and nothing added after the kernel is
+        // all the baseline processor could do, so its render is the reference for these
+        bool hasBaselineEquivalent() const noexcept
+        {
+            return detection == 0 && topology == 0 && kneeDb == 0.0f && link == 0 && bands == 0
+                && drive == 0.0f && ! autoRelease && lookaheadMs == 0.0f && oversampling == 0;
+        }
+
+        // The baseline processor is per sample without smoothing, so only channels and rate matter
+        juce::String getBaselineName() const
+        {
+            return "baseline_ch" + juce::String (numChannels) + "_sr" + juce::String ((int) sampleRate);
+        }
+    };
+
+    struct Measurement
+    {
+        double nsPerSample = 0.0;
+        double cyclesPerSample = 0.0;   // 0 when the CPU has no usable cycle counter
+    };
+
+    //==============================================================================
+    inline juce::uint64 readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL
+        return (juce::uint64) __rdtsc();
+       #else
+        return 0;
+       #endif
+    }
+
+    // Noise with level steps every 100 ms, so the detector attacks and releases all the time
+    inline void fillTestSignal (juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        juce::Random random (0x551);
+        const int stepLength = juce::jmax (1, (int) (sampleRate * 0.1));
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const float level = (i / stepLength) % 2 == 0 ? 0.8f : 0.05f;
+                data[i] = level * (2.0f * random.nextFloat() - 1.0f);
+            }
+        }
+    }
+
+    // The baseline processor registers its parameters twice and reads the copy added last
+    inline juce::RangedAudioParameter* findParameter (juce::AudioProcessor& processor, const juce::String& parameterID)
+    {
+        juce::RangedAudioParameter* found = nullptr;
+
+        for (auto* parameter : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter))
+                if (ranged->getParameterID() == parameterID)
+                    found = ranged;
+
+        return found;
+    }
+
+    inline void setParameter (juce::AudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        for (auto* parameter : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter))
+                if (ranged->getParameterID() == parameterID)
+                    ranged->setValueNotifyingHost (ranged->convertTo0to1 (value));
+    }
+
+    // The curve and ballistics every configuration starts from
+    inline void setCommonParameters (juce::AudioProcessor& processor)
+    {
+        setParameter (processor, "threshold", -20.0f);
+        setParameter (processor, "ratio", 4.0f);
+        setParameter (processor, "makeup", 0.0f);
+        setParameter (processor, "attack", 1.0f);
+        setParameter (processor, "release", 50.0f);
+    }
+
+    inline bool setLayout (juce::AudioProcessor& processor, int numChannels)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (juce::AudioChannelSet::canonicalChannelSet (numChannels));
+        layout.outputBuses.add (layout.inputBuses.getReference (0));
+        return processor.setBusesLayout (layout);
+    }
+
+    // Renders 'buffer' in place in blocks of the configured size
+    inline void render (juce::AudioProcessor& processor, const Configuration& config, juce::AudioBuffer<float>& buffer)
+    {
+        juce::MidiBuffer midi;
+        auto* threshold = findParameter (processor, "threshold");
+        auto* ratio = findParameter (processor, "ratio");
+
+        for (int start = 0; start < buffer.getNumSamples(); start += config.blockSize)
+        {
+            const int numSamples = juce::jmin (config.blockSize, buffer.getNumSamples() - start);
+
+            if (config.automated)
+            {
+                // A slow threshold and ratio sweep, as a host would send it once per block
+                const double phase = juce::MathConstants<double>::twoPi * start / config.sampleRate;
+                threshold->setValueNotifyingHost (threshold->convertTo0to1 ((float) (-30.0 + 10.0 * std::sin (phase))));
+                ratio->setValueNotifyingHost (ratio->convertTo0to1 ((float) (4.0 + 2.0 * std::sin (0.7 * phase))));
+            }
+
+            juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, numSamples);
+            processor.processBlock (block, midi);
+        }
+    }
+
+    // One second of the test signal through a freshly prepared processor, as the golden check compares it
+    inline juce::AudioBuffer<float> renderGolden (juce::AudioProcessor& processor, const Configuration& config)
+    {
+        juce::AudioBuffer<float> buffer (config.numChannels, (int) config.sampleRate);
+        fillTestSignal (buffer, config.sampleRate);
+        render (processor, config, buffer);
+        return buffer;
+    }
+
+    // Reference renders are raw float samples, one channel after the other
+    inline bool writeRender (const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+        juce::FileOutputStream stream (file);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            stream.write (buffer.getReadPointer (channel), sizeof (float) * (size_t) buffer.getNumSamples());
+
+        return stream.getStatus().wasOk();
+    }
+
+    // Renders the test signal once untimed to warm caches and settle the smoothers, then keeps the fastest of several runs
+    inline Measurement measure (juce::AudioProcessor& processor, const Configuration& config, double seconds,
+                                const std::function<void()>& afterWarmUp = {})
+    {
+        constexpr int numRuns = 5;
+
+        const int length = (int) (seconds * config.sampleRate);
+        juce::AudioBuffer<float> input (config.numChannels, length), buffer (config.numChannels, length);
+        fillTestSignal (input, config.sampleRate);
+
+        buffer.makeCopyOf (input);
+        render (processor, config, buffer);
+
+        if (afterWarmUp)
+            afterWarmUp();
+
+        Measurement best { std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+        const double numSamples = (double) length * config.numChannels;
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            buffer.makeCopyOf (input);
+
+            const auto startCycles = readCycleCounter();
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            render (processor, config, buffer);
+
+            const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+            const auto cycles = readCycleCounter() - startCycles;
+
+            best.nsPerSample = juce::jmin (best.nsPerSample, juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / numSamples);
+            best.cyclesPerSample = juce::jmin (best.cyclesPerSample, (double) cycles / numSamples);
+        }
+
+        return best;
+    }
+
+    //==============================================================================
+    inline juce::Array<Configuration> getDetectorModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (int detection = 0; detection < 2; ++detection)
+            for (int topology = 0; topology < 2; ++topology)
+                for (float kneeDb : { 0.0f, 6.0f })
+                    for (int link = 0; link < 2; ++link)
+                    {
+                        Configuration config;
+                        config.detection = detection;
+                        config.topology = topology;
+                        config.kneeDb = kneeDb;
+                        config.link = link;
+                        modes.add (config);
+                    }
+
+        return modes;
+    }
+
+    // Every band count, in each detection mode
+    inline juce::Array<Configuration> getMultibandModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (int detection = 0; detection < 2; ++detection)
+            for (int bands = 1; bands < 4; ++bands)
+            {
+                Configuration config;
+                config.detection = detection;
+                config.bands = bands;
+                modes.add (config);
+            }
+
+        return modes;
+    }
+
+    // The saturation stage after the full-band and the 3-band kernel
+    inline juce::Array<Configuration> getSaturationModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (int bands : { 0, 2 })
+        {
+            Configuration config;
+            config.bands = bands;
+            config.drive = 50.0f;
+            modes.add (config);
+        }
+
+        return modes;
+    }
+
+    // Auto release in both topologies, and on the 3-band kernel
+    inline juce::Array<Configuration> getAutoReleaseModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (int topology = 0; topology < 2; ++topology)
+        {
+            Configuration config;
+            config.topology = topology;
+            config.autoRelease = true;
+            modes.add (config);
+        }
+
+        Configuration bandConfig;
+        bandConfig.bands = 2;
+        bandConfig.autoRelease = true;
+        modes.add (bandConfig);
+
+        return modes;
+    }
+
+    // The exact and fast tiers (high is the default), in both detection modes
+    inline juce::Array<Configuration> getPrecisionModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (int detection = 0; detection < 2; ++detection)
+            for (int precision : { 0, 2 })
+            {
+                Configuration config;
+                config.detection = detection;
+                config.precision = precision;
+                modes.add (config);
+            }
+
+        return modes;
+    }
+
+    // Short and long lookahead on the full-band kernel, and lookahead on the 3-band kernel
+    inline juce::Array<Configuration> getLookaheadModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (float lookaheadMs : { 1.0f, 5.0f })
+        {
+            Configuration config;
+            config.lookaheadMs = lookaheadMs;
+            modes.add (config);
+        }
+
+        Configuration bandConfig;
+        bandConfig.bands = 2;
+        bandConfig.lookaheadMs = 5.0f;
+        modes.add (bandConfig);
+
+        return modes;
+    }
+
+    // Every factor with both filters, and 2x with lookahead, whose length then counts oversampled samples
+    inline juce::Array<Configuration> getOversamplingModes()
+    {
+        juce::Array<Configuration> modes;
+
+        for (int filter = 0; filter < 2; ++filter)
+            for (int oversampling = 1; oversampling < 4; ++oversampling)
+            {
+                Configuration config;
+                config.oversampling = oversampling;
+                config.oversamplingFilter = filter;
+                modes.add (config);
+            }
+
+        Configuration lookaheadConfig;
+        lookaheadConfig.oversampling = 1;
+        lookaheadConfig.lookaheadMs = 5.0f;
+        modes.add (lookaheadConfig);
+
+        return modes;
+    }
+
+    inline juce::Array<Configuration> getGoldenConfigurations()
+    {
+        auto configs = getDetectorModes();
+        configs.addArray (getMultibandModes());
+        configs.addArray (getSaturationModes());
+        configs.addArray (getAutoReleaseModes());
+        configs.addArray (getPrecisionModes());
+        configs.addArray (getLookaheadModes());
+        configs.addArray (getOversamplingModes());
+        return configs;
+    }
+
+    inline juce::Array<Configuration> getTimingConfigurations (bool full)
+    {
+        const int blockSizes[] = { 16, 64, 256, 1024, 4096 };
+        const int channelCounts[] = { 1, 2, 6, 12 };
+        const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+        juce::Array<Configuration> configs;
+
+        if (full)
+        {
+            auto modes = getDetectorModes();
+            modes.addArray (getMultibandModes());
+            modes.addArray (getSaturationModes());
+            modes.addArray (getAutoReleaseModes());
+
+            for (auto mode : modes)
+                for (int blockSize : blockSizes)
+                    for (int numChannels : channelCounts)
+                        for (double sampleRate : sampleRates)
+                            for (bool automated : { false, true })
+                            {
+                                auto config = mode;
+                                config.blockSize = blockSize;
+                                config.numChannels = numChannels;
+                                config.sampleRate = sampleRate;
+                                config.automated = automated;
+                                configs.add (config);
+                            }
+
+            return configs;
+        }
+
+        for (int blockSize : blockSizes)
+        {
+            Configuration config;
+            config.blockSize = blockSize;
+            configs.add (config);
+        }
+
+        for (int numChannels : channelCounts)
+        {
+            Configuration config;
+            config.numChannels = numChannels;
+            configs.add (config);
+        }
+
+        for (double sampleRate : sampleRates)
+        {
+            Configuration config;
+            config.sampleRate = sampleRate;
+            configs.add (config);
+        }
+
+        for (bool automated : { false, true })
+        {
+            Configuration config;
+            config.automated = automated;
+            configs.add (config);
+        }
+
+        configs.addArray (getDetectorModes());
+        configs.addArray (getMultibandModes());
+        configs.addArray (getSaturationModes());
+        configs.addArray (getAutoReleaseModes());
+        return configs;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "GainComputer.h"
+#include "Lookahead.h"
+#include "LinkLayout.h"
+
+//==============================================================================
+// Compile-time specialised compressor kernels.
+//
+// SSLCompressorKernel is assembled from four policies (detection, topology,
+// knee and link), so every combination compiles to its own branch-free loop.
+// The processor resolves the combination once per block through
+// SSLCompressorKernels::select and calls the returned function pointer.
+// Everything is templated on the sample type, float and double kernels are
+// separate instantiations with their own vectorised stages.
+
+// Recursive state carried from block to block, stored as structure-of-arrays
+// indexed by detector lane (the channel owning the lane, see SSLLinkLayout).
+template <typename SampleType>
+struct SSLKernelState
+{
+    SampleType envelope[SSLLinkLayout::maxChannels] {};     // smoothed gain change in dB
+    SampleType held[SSLLinkLayout::maxChannels] {};         // auto release hold, 0 to 1
+    SampleType meanSquare[SSLLinkLayout::maxChannels] {};   // RMS detector
+
+    void reset() noexcept      { *this = {}; }
+};
+
+// Everything a kernel reads for one block. All arrays hold at least as many
+// values as the block has samples.
+template <typename SampleType>
+struct SSLKernelContext
+{
+    SampleType* const* lanes;          // one scratch lane per channel, detector lanes end up holding the linear gain
+    SampleType* temp;                  // scratch lane
+    const SampleType* thresholdDb;     // per-sample static curve parameters
+    const SampleType* slope;
+    const SampleType* makeupDb;
+    SampleType kneeDb;
+    SSLBallistics<SampleType> ballistics;
+    SampleType rmsCoeff;
+    SSLFastMath::Kernels<SampleType> math;
+    const SSLLinkLayout* link;
+    SSLLookahead<SampleType>* lookahead;   // nullptr when lookahead is off
+};
+
+//==============================================================================
+// Link policies: how the channels of a group are combined into one level.
+struct SSLMaxLink
+{
+    template <typename SampleType>
+    static void combine (SampleType* dest, const SampleType* source, int numSamples) noexcept
+    {
+        juce::FloatVectorOperations::max (dest, dest, source, numSamples);
+    }
+
+    template <typename SampleType>
+    static void finish (SampleType*, int, int) noexcept {}
+};
+
+struct SSLAverageLink
+{
+    template <typename SampleType>
+    static void combine (SampleType* dest, const SampleType* source, int numSamples) noexcept
+    {
+        juce::FloatVectorOperations::add (dest, source, numSamples);
+    }
+
+    template <typename SampleType>
+    static void finish (SampleType* dest, int numSources, int numSamples) noexcept
+    {
+        juce::FloatVectorOperations::multiply (dest, (SampleType) 1 / (SampleType) numSources, numSamples);
+    }
+};
+
+//==============================================================================
+// Detection policies: per-channel magnitude before linking, and the
+// detector level per lane after linking (interleaved lanes for the multiband kernel).
+struct SSLPeakDetection
+{
+    template <typename SampleType>
+    static void magnitude (SampleType* dest, const SampleType* input, int numSamples) noexcept
+    {
+        juce::FloatVectorOperations::abs (dest, input, numSamples);
+    }
+
+    template <typename SampleType>
+    static void level (SampleType*, int, SampleType&, SampleType) noexcept {}
+
+    template <int numLanes, typename SampleType>
+    static void levels (SampleType*, int, SampleType*, SampleType) noexcept {}
+};
+
+struct SSLRmsDetection
+{
+    // Linking works on squares, so 'max' picks the loudest channel and 'average' the mean power
+    template <typename SampleType>
+    static void magnitude (SampleType* dest, const SampleType* input, int numSamples) noexcept
+    {
+        juce::FloatVectorOperations::multiply (dest, input, input, numSamples);
+    }
+
+    template <typename SampleType>
+    static void level (SampleType* data, int numSamples, SampleType& meanSquare, SampleType coeff) noexcept
+    {
+        SSLGainComputer::runMeanSquare (data, numSamples, meanSquare, coeff);
+    }
+
+    template <int numLanes, typename SampleType>
+    static void levels (SampleType* data, int numFrames, SampleType* meanSquares, SampleType coeff) noexcept
+    {
+        SSLGainComputer::runMeanSquares<numLanes> (data, numFrames, meanSquares, coeff);
+    }
+};
+
+//==============================================================================
+// Knee policies: gain change in dB for a level 'overDb' above threshold.
+struct SSLHardKnee
+{
+    template <typename SampleType>
+    static SampleType curve (SampleType overDb, SampleType slope, SampleType) noexcept
+    {
+        return juce::jmin ((SampleType) 0, overDb * slope);
+    }
+
+    template <typename SampleType>
+    static void curve (SampleType* data, int numSamples, const SampleType* thresholdDb, const SampleType* slope, SampleType) noexcept
+    {
+        SSLGainComputer::staticCurve (data, numSamples, thresholdDb, slope);
+    }
+};
+
+struct SSLSoftKnee
+{
+    // Quadratic knee of width kneeDb centred on the threshold, written with
+    // clamps instead of branches so the block loop vectorises.
+    template <typename SampleType>
+    static SampleType curve (SampleType overDb, SampleType slope, SampleType kneeDb) noexcept
+    {
+        const SampleType halfKnee = (SampleType) 0.5 * kneeDb;
+        const SampleType inKnee = juce::jlimit ((SampleType) 0, kneeDb, overDb + halfKnee);
+
+        return slope * (inKnee * inKnee / ((SampleType) 2 * kneeDb) + juce::jmax ((SampleType) 0, overDb - halfKnee));
+    }
+
+    template <typename SampleType>
+    static void curve (SampleType* data, int numSamples, const SampleType* thresholdDb, const SampleType* slope, SampleType kneeDb) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = curve (data[i] - thresholdDb[i], slope[i], kneeDb);
+    }
+};
+
+//==============================================================================
+// Topology policies: turn a lane's level in dB into the smoothed gain change in dB.
+// detectorLevel is the level the static curve sees for one sample, given the envelope so far.
+struct SSLFeedForward
+{
+    template <typename SampleType>
+    static SampleType detectorLevel (SampleType levelDb, SampleType) noexcept
+    {
+        return levelDb;
+    }
+
+    template <typename Knee, typename SampleType>
+    static void computeGain (SampleType* data, SampleType& envelope, SampleType& held, const SSLKernelContext<SampleType>& context, int numSamples) noexcept
+    {
+        Knee::curve (data, numSamples, context.thresholdDb, context.slope, context.kneeDb);
+        SSLGainComputer::runEnvelope (data, numSamples, envelope, held, context.ballistics);
+    }
+};
+
+struct SSLFeedback
+{
+    // The detector listens to the compressor's own output. In dB that is the
+    // input level plus the gain change already applied, so the log conversion
+    // stays a vectorised block stage and only the curve joins the recursion.
+    // For RMS detection this treats the gain as constant over the RMS window.
+    template <typename SampleType>
+    static SampleType detectorLevel (SampleType levelDb, SampleType envelope) noexcept
+    {
+        return levelDb + envelope;
+    }
+
+    template <typename Knee, typename SampleType>
+    static void computeGain (SampleType* data, SampleType& envelope, SampleType& held, const SSLKernelContext<SampleType>& context, int numSamples) noexcept
+    {
+        SampleType env = envelope, hold = held;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType target = Knee::curve (detectorLevel (data[i], env) - context.thresholdDb[i], context.slope[i], context.kneeDb);
+            env = SSLGainComputer::smooth (env, hold, target, context.ballistics);
+            data[i] = env;
+        }
+
+        envelope = env;
+        held = hold;
+    }
+};
+
+//==============================================================================
+// One call processes every channel of the block: magnitudes, linking, then
+// the gain computer once per detector lane, then the gain multiply.
+template <typename SampleType, typename Detection, typename Topology, typename Knee, typename Link>
+struct SSLCompressorKernel
+{
+    static void process (const juce::dsp::AudioBlock<SampleType>& block, SSLKernelState<SampleType>& state,
+                         const SSLKernelContext<SampleType>& context) noexcept
+    {
+        const auto& link = *context.link;
+        const int numSamples = (int) block.getNumSamples();
+        const int numChannels = juce::jmin ((int) block.getNumChannels(), link.numChannels);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            Detection::magnitude (context.lanes[channel], block.getChannelPointer ((size_t) channel), numSamples);
+
+        linkChannels (link, context, numSamples);
+
+        for (int i = 0; i < link.numLanes; ++i)
+        {
+            const int lane = link.laneChannels[i];
+            SampleType* data = context.lanes[lane];
+
+            Detection::level (data, numSamples, state.meanSquare[lane], context.rmsCoeff);
+
+            if (context.lookahead != nullptr)
+                context.lookahead->processDetector (lane, data, numSamples);
+
+            SSLGainComputer::levelToDecibels (data, numSamples, context.math);
+            Topology::template computeGain<Knee> (data, state.envelope[lane], state.held[lane], context, numSamples);
+            SSLGainComputer::settleEnvelope (state.envelope[lane]);
+            SSLGainComputer::settleHold (state.held[lane]);
+            SSLGainComputer::decibelsToGain (data, numSamples, context.makeupDb, context.math);
+        }
+
+        if (context.lookahead != nullptr)
+            context.lookahead->processAudio (block);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::multiply (block.getChannelPointer ((size_t) channel),
+                                                   context.lanes[link.laneOfChannel[channel]], numSamples);
+    }
+
+    // In place on context.lanes. The multiband kernel links each band the same way.
+    static void linkChannels (const SSLLinkLayout& link, const SSLKernelContext<SampleType>& context, int numSamples) noexcept
+    {
+        for (int group = 0; group < link.numGroups; ++group)
+        {
+            const int size = link.groupSize[group];
+            const int* channels = link.groupChannels[group];
+
+            if (size < 2 || link.linkAmount <= 0.0f)
+                continue;
+
+            if (link.fullyLinked)
+            {
+                // The group's first lane becomes its only detector
+                SampleType* dest = context.lanes[channels[0]];
+
+                for (int i = 1; i < size; ++i)
+                    Link::combine (dest, context.lanes[channels[i]], numSamples);
+
+                Link::finish (dest, size, numSamples);
+            }
+            else
+            {
+                // Blend every channel towards the group level: x = x * (1 - a) + group * a
+                juce::FloatVectorOperations::copy (context.temp, context.lanes[channels[0]], numSamples);
+
+                for (int i = 1; i < size; ++i)
+                    Link::combine (context.temp, context.lanes[channels[i]], numSamples);
+
+                Link::finish (context.temp, size, numSamples);
+
+                const auto amount = (SampleType) link.linkAmount;
+
+                for (int i = 0; i < size; ++i)
+                {
+                    SampleType* data = context.lanes[channels[i]];
+                    juce::FloatVectorOperations::multiply (data, (SampleType) 1 - amount, numSamples);
+                    juce::FloatVectorOperations::addWithMultiply (data, context.temp, amount, numSamples);
+                }
+            }
+        }
+    }
+};
+
+//==============================================================================
+struct SSLCompressorKernels
+{
+    template <typename SampleType>
+    using ProcessFunction = void (*) (const juce::dsp::AudioBlock<SampleType>&, SSLKernelState<SampleType>&, const SSLKernelContext<SampleType>&);
+
+    enum class Detection    { peak = 0, rms };
+    enum class Topology     { feedForward = 0, feedback };
+    enum class StereoLink   { maximum = 0, average };
+
+    template <typename SampleType>
+    static ProcessFunction<SampleType> select (Detection detection, Topology topology, bool softKnee, StereoLink link) noexcept
+    {
+        return selectFor<SSLCompressorKernel, SampleType> (detection, topology, softKnee, link);
+    }
+
+    // The same selection for any kernel template taking the four policies, e.g. SSLMultibandKernel
+    template <template <typename, typename, typename, typename, typename> class Kernel, typename SampleType>
+    static auto selectFor (Detection detection, Topology topology, bool softKnee, StereoLink link) noexcept
+    {
+        return detection == Detection::rms ? selectTopology<Kernel, SampleType, SSLRmsDetection> (topology, softKnee, link)
+                                           : selectTopology<Kernel, SampleType, SSLPeakDetection> (topology, softKnee, link);
+    }
+
+private:
+    template <template <typename, typename, typename, typename, typename> class Kernel, typename SampleType, typename DetectionPolicy>
+    static auto selectTopology (Topology topology, bool softKnee, StereoLink link) noexcept
+    {
+        return topology == Topology::feedback ? selectKnee<Kernel, SampleType, DetectionPolicy, SSLFeedback> (softKnee, link)
+                                              : selectKnee<Kernel, SampleType, DetectionPolicy, SSLFeedForward> (softKnee, link);
+    }
+
+    template <template <typename, typename, typename, typename, typename> class Kernel, typename SampleType,
+              typename DetectionPolicy, typename TopologyPolicy>
+    static auto selectKnee (bool softKnee, StereoLink link) noexcept
+    {
+        return softKnee ? selectLink<Kernel, SampleType, DetectionPolicy, TopologyPolicy, SSLSoftKnee> (link)
+                        : selectLink<Kernel, SampleType, DetectionPolicy, TopologyPolicy, SSLHardKnee> (link);
+    }
+
+    template <template <typename, typename, typename, typename, typename> class Kernel, typename SampleType,
+              typename DetectionPolicy, typename TopologyPolicy, typename KneePolicy>
+    static auto selectLink (StereoLink link) noexcept
+    {
+        return link == StereoLink::average ? &Kernel<SampleType, DetectionPolicy, TopologyPolicy, KneePolicy, SSLAverageLink>::process
+                                           : &Kernel<SampleType, DetectionPolicy, TopologyPolicy, KneePolicy, SSLMaxLink>::process;
+    }
+};
\ No newline at end of file
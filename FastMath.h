@@ -0,0 +1,499 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SSL_FASTMATH_SSE2 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ #include <arm_neon.h>
+ #define SSL_FASTMATH_NEON 1
+#endif
+
+//==============================================================================
+// Approximate log2/exp2 kernels for the detector's dB conversions.
+//
+// log2 splits the float into exponent and mantissa and fits log2 (1 + u) on the
+// mantissa; exp2 splits off the integer part, builds 2^i in the exponent bits
+// and fits 2^f on the fraction. The same code runs on scalars and on SSE2/NEON
+// registers, so the scalar and SIMD paths share identical error bounds.
+//
+// Everything is provided for float and for double samples. The double kernels
+// use the same polynomials on doubles (two lanes per SSE2/NEON register), so
+// the approximate tiers have the same error bounds in both precisions while
+// the exact tier is libm at full double precision.
+//
+// Inputs to log2 must be positive normal numbers (the detector adds 1e-6 before
+// converting), exp2 clamps its input to [-126, 126].
+//
+// Measured maximum error against a long double reference over the detector's
+// working range (level 1e-6..16, gain -200..+40 dB), rounding of the inputs and
+// outputs included. Cost is both conversions on SSE2, relative to the exact tier:
+//
+//   Precision   levelToDecibels   decibelsToGain   cost
+//   exact       < 1e-5 dB         < 1e-5 dB        1x (libm)
+//   high        < 1.5e-5 dB       < 1.5e-5 dB      ~0.14x
+//   fast        < 5e-3 dB         < 8e-4 dB        ~0.09x
+//
+// The exact tier's gain error is float rounding of dB / 20 at large gains.
+// With double samples the exact tier is within 1e-13 dB. The approximate tiers
+// evaluate the float fits' coefficients in double, so what remains is the
+// error of the fits themselves: high below 2e-6 dB for levelToDecibels and
+// 1e-6 dB for decibelsToGain, fast as with float samples.
+struct SSLFastMath
+{
+    enum class Precision
+    {
+        exact = 0,
+        high,
+        fast
+    };
+
+    //==============================================================================
+    template <Precision precision, typename SampleType>
+    static SampleType log2 (SampleType x) noexcept
+    {
+        if constexpr (precision == Precision::exact)
+            return std::log2 (x);
+        else
+            return log2Impl<ScalarOps<SampleType>, precision> (x);
+    }
+
+    template <Precision precision, typename SampleType>
+    static SampleType exp2 (SampleType x) noexcept
+    {
+        if constexpr (precision == Precision::exact)
+            return std::exp2 (x);
+        else
+            return exp2Impl<ScalarOps<SampleType>, precision> (x);
+    }
+
+    //==============================================================================
+    // In-place block conversions used by SSLGainComputer.
+    template <typename SampleType>
+    using BlockFunction = void (*) (SampleType* data, int numSamples);
+
+    template <typename SampleType>
+    struct Kernels
+    {
+        BlockFunction<SampleType> levelToDecibels; // data[i] = 20 * log10 (data[i])
+        BlockFunction<SampleType> decibelsToGain;  // data[i] = 10 ^ (data[i] / 20)
+    };
+
+    // Resolves the kernels for a precision tier; call this from prepareToPlay,
+    // not per sample.
+    template <typename SampleType>
+    static Kernels<SampleType> getKernels (Precision precision) noexcept
+    {
+        switch (precision)
+        {
+            case Precision::fast:   return { levelToDecibelsBlock<SampleType, Precision::fast>,  decibelsToGainBlock<SampleType, Precision::fast> };
+            case Precision::high:   return { levelToDecibelsBlock<SampleType, Precision::high>,  decibelsToGainBlock<SampleType, Precision::high> };
+            case Precision::exact:
+            default:                return { levelToDecibelsBlock<SampleType, Precision::exact>, decibelsToGainBlock<SampleType, Precision::exact> };
+        }
+    }
+
+private:
+    static constexpr double decibelsPerOctave = 6.0205999132796239;  // 20 * log10 (2)
+    static constexpr double octavesPerDecibel = 0.1660964047443681;  // log2 (10) / 20
+
+    //==============================================================================
+    // Minimax fits: log2 (1 + u) = u * P (u) and 2^u = 1 + u * P (u) for u in [0, 1).
+    struct Log2High
+    {
+        static constexpr float coeffs[] = { 1.44266783f, -0.72058544f, 0.473553176f, -0.325901119f,
+                                            0.194292804f, -0.0795564336f, 0.0155294915f };
+    };
+
+    struct Log2Fast
+    {
+        static constexpr float coeffs[] = { 1.42459211f, -0.589199599f, 0.165377588f };
+    };
+
+    struct Exp2High
+    {
+        static constexpr float coeffs[] = { 0.693151313f, 0.240164438f, 0.0557999558f, 0.00901697078f, 0.00186715816f };
+    };
+
+    struct Exp2Fast
+    {
+        static constexpr float coeffs[] = { 0.695117041f, 0.227643878f, 0.0770680697f };
+    };
+
+    template <Precision precision>
+    using Log2Poly = std::conditional_t<precision == Precision::fast, Log2Fast, Log2High>;
+
+    template <Precision precision>
+    using Exp2Poly = std::conditional_t<precision == Precision::fast, Exp2Fast, Exp2High>;
+
+    //==============================================================================
+    // Register abstractions. Besides plain arithmetic each one knows its IEEE
+    // layout: exponent() and mantissa() split x = 2^e * m with m in [1, 2), and
+    // pow2() builds 2^i from an integer. isGreater() gives 1 where a > b and 0
+    // elsewhere, for blending without branches.
+    struct ScalarFloatOps
+    {
+        using Sample = float;
+        using Float = float;
+        using Int = int32_t;
+
+        static Float load (const float* p) noexcept                 { return *p; }
+        static void store (float* p, Float x) noexcept              { *p = x; }
+        static Float splat (float x) noexcept                       { return x; }
+        static Float add (Float a, Float b) noexcept                { return a + b; }
+        static Float sub (Float a, Float b) noexcept                { return a - b; }
+        static Float mul (Float a, Float b) noexcept                { return a * b; }
+        static Float min (Float a, Float b) noexcept                { return a < b ? a : b; }
+        static Float max (Float a, Float b) noexcept                { return a < b ? b : a; }
+        static Float div (Float a, Float b) noexcept                { return a / b; }
+        static Float abs (Float a) noexcept                         { return std::abs (a); }
+        static Float isGreater (Float a, Float b) noexcept          { return a > b ? (Float) 1 : (Float) 0; }
+        static Float toFloat (Int a) noexcept                       { return (Float) a; }
+        static Int floorToInt (Float a) noexcept                    { return (Int) std::floor (a); }
+
+        static Float exponent (Float x) noexcept                    { return (Float) ((int32_t) ((uint32_t) asInt (x) >> 23) - 127); }
+        static Float mantissa (Float x) noexcept                    { return asFloat ((asInt (x) & 0x007fffff) | 0x3f800000); }
+        static Float pow2 (Int i) noexcept                          { return asFloat ((Int) ((uint32_t) (i + 127) << 23)); }
+
+        static Int asInt (Float a) noexcept                         { Int i; std::memcpy (&i, &a, sizeof (i)); return i; }
+        static Float asFloat (Int a) noexcept                       { Float f; std::memcpy (&f, &a, sizeof (f)); return f; }
+
+        static constexpr int width = 1;
+    };
+
+    struct ScalarDoubleOps
+    {
+        using Sample = double;
+        using Float = double;
+        using Int = int64_t;
+
+        static Float load (const double* p) noexcept                { return *p; }
+        static void store (double* p, Float x) noexcept             { *p = x; }
+        static Float splat (double x) noexcept                      { return x; }
+        static Float add (Float a, Float b) noexcept                { return a + b; }
+        static Float sub (Float a, Float b) noexcept                { return a - b; }
+        static Float mul (Float a, Float b) noexcept                { return a * b; }
+        static Float min (Float a, Float b) noexcept                { return a < b ? a : b; }
+        static Float max (Float a, Float b) noexcept                { return a < b ? b : a; }
+        static Float div (Float a, Float b) noexcept                { return a / b; }
+        static Float abs (Float a) noexcept                         { return std::abs (a); }
+        static Float isGreater (Float a, Float b) noexcept          { return a > b ? (Float) 1 : (Float) 0; }
+        static Float toFloat (Int a) noexcept                       { return (Float) a; }
+        static Int floorToInt (Float a) noexcept                    { return (Int) std::floor (a); }
+
+        static Float exponent (Float x) noexcept                    { return (Float) ((int64_t) ((uint64_t) asInt (x) >> 52) - 1023); }
+        static Float mantissa (Float x) noexcept                    { return asFloat ((asInt (x) & 0x000fffffffffffffLL) | 0x3ff0000000000000LL); }
+        static Float pow2 (Int i) noexcept                          { return asFloat ((Int) ((uint64_t) (i + 1023) << 52)); }
+
+        static Int asInt (Float a) noexcept                         { Int i; std::memcpy (&i, &a, sizeof (i)); return i; }
+        static Float asFloat (Int a) noexcept                       { Float f; std::memcpy (&f, &a, sizeof (f)); return f; }
+
+        static constexpr int width = 1;
+    };
+
+   #if SSL_FASTMATH_SSE2
+    struct VectorFloatOps
+    {
+        using Sample = float;
+        using Float = __m128;
+        using Int = __m128i;
+
+        static Float load (const float* p) noexcept                 { return _mm_loadu_ps (p); }
+        static void store (float* p, Float x) noexcept              { _mm_storeu_ps (p, x); }
+        static Float splat (float x) noexcept                       { return _mm_set1_ps (x); }
+        static Float add (Float a, Float b) noexcept                { return _mm_add_ps (a, b); }
+        static Float sub (Float a, Float b) noexcept                { return _mm_sub_ps (a, b); }
+        static Float mul (Float a, Float b) noexcept                { return _mm_mul_ps (a, b); }
+        static Float min (Float a, Float b) noexcept                { return _mm_min_ps (a, b); }
+        static Float max (Float a, Float b) noexcept                { return _mm_max_ps (a, b); }
+        static Float div (Float a, Float b) noexcept                { return _mm_div_ps (a, b); }
+        static Float abs (Float a) noexcept                         { return _mm_andnot_ps (_mm_set1_ps (-0.0f), a); }
+        static Float isGreater (Float a, Float b) noexcept          { return _mm_and_ps (_mm_cmpgt_ps (a, b), _mm_set1_ps (1.0f)); }
+        static Float toFloat (Int a) noexcept                       { return _mm_cvtepi32_ps (a); }
+
+        static Int floorToInt (Float a) noexcept
+        {
+            // Truncate, then step down by one where truncation rounded a negative value up
+            const auto truncated = _mm_cvttps_epi32 (a);
+            const auto roundedUp = _mm_cmpgt_ps (_mm_cvtepi32_ps (truncated), a);
+            return _mm_add_epi32 (truncated, _mm_castps_si128 (roundedUp));
+        }
+
+        static Float exponent (Float x) noexcept
+        {
+            return _mm_cvtepi32_ps (_mm_sub_epi32 (_mm_srli_epi32 (_mm_castps_si128 (x), 23), _mm_set1_epi32 (127)));
+        }
+
+        static Float mantissa (Float x) noexcept
+        {
+            return _mm_castsi128_ps (_mm_or_si128 (_mm_and_si128 (_mm_castps_si128 (x), _mm_set1_epi32 (0x007fffff)),
+                                                   _mm_set1_epi32 (0x3f800000)));
+        }
+
+        static Float pow2 (Int i) noexcept
+        {
+            return _mm_castsi128_ps (_mm_slli_epi32 (_mm_add_epi32 (i, _mm_set1_epi32 (127)), 23));
+        }
+
+        static constexpr int width = 4;
+    };
+
+    struct VectorDoubleOps
+    {
+        using Sample = double;
+        using Float = __m128d;
+        using Int = __m128i;   // two int32 in the low lanes, as produced by _mm_cvttpd_epi32
+
+        static Float load (const double* p) noexcept                { return _mm_loadu_pd (p); }
+        static void store (double* p, Float x) noexcept             { _mm_storeu_pd (p, x); }
+        static Float splat (double x) noexcept                      { return _mm_set1_pd (x); }
+        static Float add (Float a, Float b) noexcept                { return _mm_add_pd (a, b); }
+        static Float sub (Float a, Float b) noexcept                { return _mm_sub_pd (a, b); }
+        static Float mul (Float a, Float b) noexcept                { return _mm_mul_pd (a, b); }
+        static Float min (Float a, Float b) noexcept                { return _mm_min_pd (a, b); }
+        static Float max (Float a, Float b) noexcept                { return _mm_max_pd (a, b); }
+        static Float div (Float a, Float b) noexcept                { return _mm_div_pd (a, b); }
+        static Float abs (Float a) noexcept                         { return _mm_andnot_pd (_mm_set1_pd (-0.0), a); }
+        static Float isGreater (Float a, Float b) noexcept          { return _mm_and_pd (_mm_cmpgt_pd (a, b), _mm_set1_pd (1.0)); }
+        static Float toFloat (Int a) noexcept                       { return _mm_cvtepi32_pd (a); }
+
+        static Int floorToInt (Float a) noexcept
+        {
+            const auto truncated = _mm_cvttpd_epi32 (a);
+            const auto roundedUp = _mm_cmpgt_pd (_mm_cvtepi32_pd (truncated), a);
+
+            // The comparison mask has one all-ones 64-bit lane per double, move it to the low int32 lanes
+            return _mm_add_epi32 (truncated, _mm_shuffle_epi32 (_mm_castpd_si128 (roundedUp), _MM_SHUFFLE (3, 3, 2, 0)));
+        }
+
+        static Float exponent (Float x) noexcept
+        {
+            // The exponent sits in the high 32 bits of each lane, gather those into the low lanes first
+            const auto high = _mm_shuffle_epi32 (_mm_castpd_si128 (x), _MM_SHUFFLE (3, 3, 3, 1));
+            return _mm_cvtepi32_pd (_mm_sub_epi32 (_mm_srli_epi32 (high, 20), _mm_set1_epi32 (1023)));
+        }
+
+        static Float mantissa (Float x) noexcept
+        {
+            return _mm_castsi128_pd (_mm_or_si128 (_mm_and_si128 (_mm_castpd_si128 (x), _mm_set1_epi64x (0x000fffffffffffffLL)),
+                                                   _mm_set1_epi64x (0x3ff0000000000000LL)));
+        }
+
+        static Float pow2 (Int i) noexcept
+        {
+            // Biased exponents into the high 32 bits of each 64-bit lane, low bits zero
+            const auto biased = _mm_add_epi32 (i, _mm_set1_epi32 (1023));
+            return _mm_castsi128_pd (_mm_slli_epi32 (_mm_unpacklo_epi32 (_mm_setzero_si128(), biased), 20));
+        }
+
+        static constexpr int width = 2;
+    };
+   #elif SSL_FASTMATH_NEON
+    struct VectorFloatOps
+    {
+        using Sample = float;
+        using Float = float32x4_t;
+        using Int = int32x4_t;
+
+        static Float load (const float* p) noexcept                 { return vld1q_f32 (p); }
+        static void store (float* p, Float x) noexcept              { vst1q_f32 (p, x); }
+        static Float splat (float x) noexcept                       { return vdupq_n_f32 (x); }
+        static Float add (Float a, Float b) noexcept                { return vaddq_f32 (a, b); }
+        static Float sub (Float a, Float b) noexcept                { return vsubq_f32 (a, b); }
+        static Float mul (Float a, Float b) noexcept                { return vmulq_f32 (a, b); }
+        static Float min (Float a, Float b) noexcept                { return vminq_f32 (a, b); }
+        static Float max (Float a, Float b) noexcept                { return vmaxq_f32 (a, b); }
+        static Float abs (Float a) noexcept                         { return vabsq_f32 (a); }
+        static Float toFloat (Int a) noexcept                       { return vcvtq_f32_s32 (a); }
+
+        static Float div (Float a, Float b) noexcept
+        {
+           #if defined (__aarch64__) || defined (_M_ARM64)
+            return vdivq_f32 (a, b);
+           #else
+            // ARMv7 has no vector divide: reciprocal estimate and two Newton-Raphson steps
+            auto r = vrecpeq_f32 (b);
+            r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+            r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+            return vmulq_f32 (a, r);
+           #endif
+        }
+
+        static Float isGreater (Float a, Float b) noexcept
+        {
+            return vreinterpretq_f32_u32 (vandq_u32 (vcgtq_f32 (a, b), vreinterpretq_u32_f32 (vdupq_n_f32 (1.0f))));
+        }
+
+        static Int floorToInt (Float a) noexcept
+        {
+            const auto truncated = vcvtq_s32_f32 (a);
+            const auto roundedUp = vcgtq_f32 (vcvtq_f32_s32 (truncated), a);
+            return vaddq_s32 (truncated, vreinterpretq_s32_u32 (roundedUp));
+        }
+
+        static Float exponent (Float x) noexcept
+        {
+            const auto bits = vreinterpretq_u32_f32 (x);
+            return vcvtq_f32_s32 (vsubq_s32 (vreinterpretq_s32_u32 (vshrq_n_u32 (bits, 23)), vdupq_n_s32 (127)));
+        }
+
+        static Float mantissa (Float x) noexcept
+        {
+            const auto bits = vreinterpretq_s32_f32 (x);
+            return vreinterpretq_f32_s32 (vorrq_s32 (vandq_s32 (bits, vdupq_n_s32 (0x007fffff)), vdupq_n_s32 (0x3f800000)));
+        }
+
+        static Float pow2 (Int i) noexcept
+        {
+            return vreinterpretq_f32_s32 (vshlq_n_s32 (vaddq_s32 (i, vdupq_n_s32 (127)), 23));
+        }
+
+        static constexpr int width = 4;
+    };
+
+    #if defined (__aarch64__) || defined (_M_ARM64)
+    struct VectorDoubleOps
+    {
+        using Sample = double;
+        using Float = float64x2_t;
+        using Int = int64x2_t;
+
+        static Float load (const double* p) noexcept                { return vld1q_f64 (p); }
+        static void store (double* p, Float x) noexcept             { vst1q_f64 (p, x); }
+        static Float splat (double x) noexcept                      { return vdupq_n_f64 (x); }
+        static Float add (Float a, Float b) noexcept                { return vaddq_f64 (a, b); }
+        static Float sub (Float a, Float b) noexcept                { return vsubq_f64 (a, b); }
+        static Float mul (Float a, Float b) noexcept                { return vmulq_f64 (a, b); }
+        static Float min (Float a, Float b) noexcept                { return vminq_f64 (a, b); }
+        static Float max (Float a, Float b) noexcept                { return vmaxq_f64 (a, b); }
+        static Float div (Float a, Float b) noexcept                { return vdivq_f64 (a, b); }
+        static Float abs (Float a) noexcept                         { return vabsq_f64 (a); }
+
+        static Float isGreater (Float a, Float b) noexcept
+        {
+            return vreinterpretq_f64_u64 (vandq_u64 (vcgtq_f64 (a, b), vreinterpretq_u64_f64 (vdupq_n_f64 (1.0))));
+        }
+
+        static Float toFloat (Int a) noexcept                       { return vcvtq_f64_s64 (a); }
+        static Int floorToInt (Float a) noexcept                    { return vcvtmq_s64_f64 (a); }
+
+        static Float exponent (Float x) noexcept
+        {
+            const auto bits = vreinterpretq_u64_f64 (x);
+            return vcvtq_f64_s64 (vsubq_s64 (vreinterpretq_s64_u64 (vshrq_n_u64 (bits, 52)), vdupq_n_s64 (1023)));
+        }
+
+        static Float mantissa (Float x) noexcept
+        {
+            const auto bits = vreinterpretq_s64_f64 (x);
+            return vreinterpretq_f64_s64 (vorrq_s64 (vandq_s64 (bits, vdupq_n_s64 (0x000fffffffffffffLL)),
+                                                     vdupq_n_s64 (0x3ff0000000000000LL)));
+        }
+
+        static Float pow2 (Int i) noexcept
+        {
+            return vreinterpretq_f64_s64 (vshlq_n_s64 (vaddq_s64 (i, vdupq_n_s64 (1023)), 52));
+        }
+
+        static constexpr int width = 2;
+    };
+    #else
+    using VectorDoubleOps = ScalarDoubleOps;
+    #endif
+   #else
+    using VectorFloatOps = ScalarFloatOps;
+    using VectorDoubleOps = ScalarDoubleOps;
+   #endif
+
+public:
+    // The registers for a sample type, also used by other block kernels (SSLSaturator)
+    template <typename SampleType>
+    using ScalarOps = std::conditional_t<std::is_same_v<SampleType, double>, ScalarDoubleOps, ScalarFloatOps>;
+
+    template <typename SampleType>
+    using VectorOps = std::conditional_t<std::is_same_v<SampleType, double>, VectorDoubleOps, VectorFloatOps>;
+
+private:
+
+    //==============================================================================
+    template <typename Ops, typename Poly>
+    static typename Ops::Float horner (typename Ops::Float u) noexcept
+    {
+        constexpr auto numCoeffs = (int) (sizeof (Poly::coeffs) / sizeof (Poly::coeffs[0]));
+
+        auto p = Ops::splat (Poly::coeffs[numCoeffs - 1]);
+
+        for (int k = numCoeffs - 2; k >= 0; --k)
+            p = Ops::add (Ops::mul (p, u), Ops::splat (Poly::coeffs[k]));
+
+        return Ops::mul (p, u);
+    }
+
+    template <typename Ops, Precision precision>
+    static typename Ops::Float log2Impl (typename Ops::Float x) noexcept
+    {
+        const auto u = Ops::sub (Ops::mantissa (x), Ops::splat (1.0f));
+        return Ops::add (Ops::exponent (x), horner<Ops, Log2Poly<precision>> (u));
+    }
+
+    template <typename Ops, Precision precision>
+    static typename Ops::Float exp2Impl (typename Ops::Float x) noexcept
+    {
+        x = Ops::min (Ops::max (x, Ops::splat (-126.0f)), Ops::splat (126.0f));
+
+        const auto integer = Ops::floorToInt (x);
+        const auto fraction = Ops::sub (x, Ops::toFloat (integer));
+
+        return Ops::mul (Ops::add (horner<Ops, Exp2Poly<precision>> (fraction), Ops::splat (1.0f)), Ops::pow2 (integer));
+    }
+
+    //==============================================================================
+    template <typename SampleType, Precision precision>
+    static void levelToDecibelsBlock (SampleType* data, int numSamples) noexcept
+    {
+        if constexpr (precision == Precision::exact)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = (SampleType) 20 * std::log10 (data[i]);
+        }
+        else
+        {
+            using Vector = VectorOps<SampleType>;
+            using Scalar = ScalarOps<SampleType>;
+
+            const auto scale = (SampleType) decibelsPerOctave;
+            int i = 0;
+
+            for (; i + Vector::width <= numSamples; i += Vector::width)
+                Vector::store (data + i, Vector::mul (log2Impl<Vector, precision> (Vector::load (data + i)), Vector::splat (scale)));
+
+            for (; i < numSamples; ++i)
+                data[i] = scale * log2Impl<Scalar, precision> (data[i]);
+        }
+    }
+
+    template <typename SampleType, Precision precision>
+    static void decibelsToGainBlock (SampleType* data, int numSamples) noexcept
+    {
+        if constexpr (precision == Precision::exact)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = std::pow ((SampleType) 10, data[i] / (SampleType) 20);
+        }
+        else
+        {
+            using Vector = VectorOps<SampleType>;
+            using Scalar = ScalarOps<SampleType>;
+
+            const auto scale = (SampleType) octavesPerDecibel;
+            int i = 0;
+
+            for (; i + Vector::width <= numSamples; i += Vector::width)
+                Vector::store (data + i, exp2Impl<Vector, precision> (Vector::mul (Vector::load (data + i), Vector::splat (scale))));
+
+            for (; i < numSamples; ++i)
+                data[i] = exp2Impl<Scalar, precision> (scale * data[i]);
+        }
+    }
+};
\ No newline at end of file
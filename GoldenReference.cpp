@@ -0,0 +1,119 @@
+//==============================================================================
+// Reference renderer for Benchmark.cpp, built against the baseline commit's
+// SSLCompressorAudioProcessor by golden_baseline.sh rather than against this
+// tree, so the golden check compares the current kernels with the original
+// scalar processBlock.
+//
+// Built as its own console application target from this file, Benchmark.h, the
+// baseline's PluginProcessor.cpp and a stub createPluginFilter written by the
+// script, with JucePlugin_Name defined. The baseline's PluginEditor.cpp doesn't
+// compile at that commit and is left out.
+//
+//   GoldenReference [options]
+//     --golden <dir>         where the reference renders go (default golden)
+//     --baseline <file>      timing baseline to write (default benchmark_baseline.txt)
+//     --full                 time the full cross product, as Benchmark --full
+//     --seconds <s>          audio rendered per timing run (default 2)
+//
+// Only configurations the baseline processor can render are written: one
+// render per channel count and sample rate of the golden set, and the timings
+// of the timing configurations under the names Benchmark uses for them.
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "Benchmark.h"
+
+#include <iostream>
+
+namespace
+{
+    using namespace SSLBenchmark;
+
+    std::unique_ptr<SSLCompressorAudioProcessor> createProcessor (const Configuration& config)
+    {
+        auto processor = std::make_unique<SSLCompressorAudioProcessor>();
+
+        if (! setLayout (*processor, config.numChannels))
+            return nullptr;
+
+        setCommonParameters (*processor);
+        processor->setRateAndBufferSizeDetails (config.sampleRate, config.blockSize);
+        processor->prepareToPlay (config.sampleRate, config.blockSize);
+        return processor;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool full = false;
+    double seconds = 2.0;
+    auto baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile ("benchmark_baseline.txt");
+    auto goldenDirectory = juce::File::getCurrentWorkingDirectory().getChildFile ("golden");
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--full")                             full = true;
+        else if (arg == "--seconds" && hasValue)         seconds = juce::jmax (0.1, juce::String (argv[++i]).getDoubleValue());
+        else if (arg == "--baseline" && hasValue)        baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else if (arg == "--golden" && hasValue)          goldenDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+        else
+        {
+            std::cout << "usage: GoldenReference [--golden <dir>] [--baseline <file>] [--full] [--seconds <s>]" << std::endl;
+            return 1;
+        }
+    }
+
+    juce::StringArray written;
+
+    for (auto& config : getGoldenConfigurations())
+    {
+        const auto name = config.getBaselineName();
+
+        if (! config.hasBaselineEquivalent() || written.contains (name))
+            continue;
+
+        auto processor = createProcessor (config);
+
+        if (processor == nullptr || ! writeRender (goldenDirectory.getChildFile (name + ".raw"), renderGolden (*processor, config)))
+        {
+            std::cerr << "can't render " << name << std::endl;
+            return 1;
+        }
+
+        std::cout << "golden " << name << std::endl;
+        written.add (name);
+    }
+
+    juce::String results ("# name ns/sample cycles/sample (baseline processor)\n");
+
+    for (auto& config : getTimingConfigurations (full))
+    {
+        if (! config.hasBaselineEquivalent())
+            continue;
+
+        auto processor = createProcessor (config);
+
+        if (processor == nullptr)
+            continue;
+
+        const auto measurement = measure (*processor, config, seconds);
+        const auto line = config.getName() + " " + juce::String (measurement.nsPerSample, 3) + " " + juce::String (measurement.cyclesPerSample, 2);
+
+        std::cout << line << std::endl;
+        results << line << "\n";
+    }
+
+    if (! baselineFile.replaceWithText (results))
+    {
+        std::cerr << "can't write " << baselineFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
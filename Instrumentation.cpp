@@ -0,0 +1,185 @@
+#include "Instrumentation.h"
+
+//==============================================================================
+// Allocation and lock hooks for the instrumented build. Everything here is
+// compiled out unless SSL_INSTRUMENTATION is 1.
+//
+// A hook only counts a call when its thread is inside an SSLBlockProbe::Scope,
+// so the rest of the process runs through them unchanged.
+//
+// Coverage depends on the platform:
+// - glibc (Linux): malloc, calloc, realloc, the aligned allocators, free and
+//   pthread_mutex_lock/trylock are wrapped, so that covers operator new,
+//   JUCE's HeapBlock, std::mutex and juce::CriticalSection.
+// - Elsewhere: only the global operator new/delete are replaced, so anything
+//   that calls malloc directly (HeapBlock, AudioBuffer) and lock use are not
+//   seen. Use the Linux build of Benchmark or BatchRender for the full check.
+//
+// The hooks are reliable in those executables. Inside a host, the plugin's own
+// calls may bind to the host's allocator first, so the counts can come out low.
+// The timing is valid everywhere.
+
+#if SSL_INSTRUMENTATION
+
+#if defined (__GNUC__)
+ #define SSL_INITIAL_EXEC_TLS __attribute__ ((tls_model ("initial-exec")))
+#else
+ #define SSL_INITIAL_EXEC_TLS
+#endif
+
+namespace
+{
+    // initial-exec keeps TLS access from allocating, which would recurse into malloc below
+    thread_local SSLBlockProbe* currentProbe SSL_INITIAL_EXEC_TLS = nullptr;
+}
+
+SSLBlockProbe* SSLBlockProbe::exchangeCurrent (SSLBlockProbe* probe) noexcept
+{
+    auto* previous = currentProbe;
+    currentProbe = probe;
+    return previous;
+}
+
+void SSLBlockProbe::countAllocation() noexcept
+{
+    if (auto* probe = currentProbe)
+        increment (probe->allocations, (juce::int64) 1);
+}
+
+void SSLBlockProbe::countDeallocation() noexcept
+{
+    if (auto* probe = currentProbe)
+        increment (probe->deallocations, (juce::int64) 1);
+}
+
+void SSLBlockProbe::countLock() noexcept
+{
+    if (auto* probe = currentProbe)
+        increment (probe->locks, (juce::int64) 1);
+}
+
+//==============================================================================
+#if defined (__GLIBC__)
+
+#include <cerrno>
+#include <dlfcn.h>
+#include <pthread.h>
+
+// glibc exports its allocator under __libc_* names, so the public entry points can be wrapped
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void __libc_free (void*);
+
+    void* malloc (size_t size)
+    {
+        SSLBlockProbe::countAllocation();
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t count, size_t size)
+    {
+        SSLBlockProbe::countAllocation();
+        return __libc_calloc (count, size);
+    }
+
+    void* realloc (void* ptr, size_t size)
+    {
+        SSLBlockProbe::countAllocation();
+        return __libc_realloc (ptr, size);
+    }
+
+    void* memalign (size_t alignment, size_t size)
+    {
+        SSLBlockProbe::countAllocation();
+        return __libc_memalign (alignment, size);
+    }
+
+    void* aligned_alloc (size_t alignment, size_t size)
+    {
+        return memalign (alignment, size);
+    }
+
+    int posix_memalign (void** result, size_t alignment, size_t size)
+    {
+        if (alignment % sizeof (void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        *result = memalign (alignment, size);
+        return *result != nullptr || size == 0 ? 0 : ENOMEM;
+    }
+
+    void free (void* ptr)
+    {
+        if (ptr != nullptr)
+            SSLBlockProbe::countDeallocation();
+
+        __libc_free (ptr);
+    }
+
+    // The mutex functions have no exported alias to forward to, so the next definition is
+    // looked up once. dlsym locks through glibc's internal lock, not through these.
+    int pthread_mutex_lock (pthread_mutex_t* mutex)
+    {
+        static const auto next = reinterpret_cast<int (*) (pthread_mutex_t*)> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+        SSLBlockProbe::countLock();
+        return next (mutex);
+    }
+
+    int pthread_mutex_trylock (pthread_mutex_t* mutex)
+    {
+        static const auto next = reinterpret_cast<int (*) (pthread_mutex_t*)> (dlsym (RTLD_NEXT, "pthread_mutex_trylock"));
+        SSLBlockProbe::countLock();
+        return next (mutex);
+    }
+}
+
+#else
+
+//==============================================================================
+void* operator new (std::size_t size)
+{
+    SSLBlockProbe::countAllocation();
+
+    if (auto* ptr = std::malloc (size != 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    return operator new (size);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    SSLBlockProbe::countAllocation();
+    return std::malloc (size != 0 ? size : 1);
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new (size, tag);
+}
+
+void operator delete (void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        SSLBlockProbe::countDeallocation();
+
+    std::free (ptr);
+}
+
+void operator delete[] (void* ptr) noexcept                                 { operator delete (ptr); }
+void operator delete (void* ptr, std::size_t) noexcept                      { operator delete (ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept                    { operator delete (ptr); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept            { operator delete (ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept          { operator delete (ptr); }
+
+#endif
+
+#endif
\ No newline at end of file
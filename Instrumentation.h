@@ -0,0 +1,176 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Opt-in real-time safety and block timing instrumentation.
+//
+// Build with SSL_INSTRUMENTATION=1 to enable it. Every processBlock call is then
+// timed into a histogram, and the hooks in Instrumentation.cpp count heap
+// allocations, releases and mutex locks made on the audio thread while the block
+// runs. Release builds leave SSL_INSTRUMENTATION at 0, which compiles all of it
+// out: no hooks, no clock reads and no probe in the processor.
+//
+// The audio thread is the only writer. Readers (the editor, BatchRender,
+// Benchmark) take an SSLBlockStats copy at any time without locking; a copy taken
+// while a block finishes may mix that block in for some fields but not others.
+
+#ifndef SSL_INSTRUMENTATION
+ #define SSL_INSTRUMENTATION 0
+#endif
+
+// What the instrumentation measured since the last reset. Times are wall-clock
+// per processBlock call; load is block time against the audio the block covers.
+struct SSLBlockStats
+{
+    juce::int64 numBlocks = 0;
+    double p50Microseconds = 0.0, p99Microseconds = 0.0, maxMicroseconds = 0.0;
+    double averageLoadPercent = 0.0;    // total block time / total audio time
+    double peakLoadPercent = 0.0;       // worst single block against its own budget
+    juce::int64 allocations = 0, deallocations = 0, locks = 0;
+
+    bool isRealtimeSafe() const noexcept    { return allocations == 0 && deallocations == 0 && locks == 0; }
+
+    juce::String toString() const
+    {
+        return juce::String (numBlocks) + " blocks, p50 " + juce::String (p50Microseconds, 1)
+             + " us, p99 " + juce::String (p99Microseconds, 1) + " us, max " + juce::String (maxMicroseconds, 1)
+             + " us, load " + juce::String (averageLoadPercent, 2) + " % (peak " + juce::String (peakLoadPercent, 1)
+             + " %), " + juce::String (allocations) + " allocs, " + juce::String (deallocations) + " frees, "
+             + juce::String (locks) + " locks";
+    }
+};
+
+#if SSL_INSTRUMENTATION
+
+//==============================================================================
+// Per-instance recorder. The histogram has binsPerOctave log-spaced bins per
+// doubling from minNanoseconds up, so a percentile is accurate to about 9 %;
+// the maximum is exact.
+class SSLBlockProbe
+{
+public:
+    static constexpr int binsPerOctave = 8;
+    static constexpr int numBins = 24 * binsPerOctave;
+    static constexpr double minNanoseconds = 100.0;
+
+    // Audio thread: times one block and arms the hooks for this probe until it goes out of scope.
+    class Scope
+    {
+    public:
+        Scope (SSLBlockProbe& probeToUse, int numSamples, double sampleRate) noexcept
+            : probe (probeToUse),
+              budgetSeconds (sampleRate > 0.0 ? numSamples / sampleRate : 0.0),
+              previous (exchangeCurrent (&probeToUse)),
+              startTicks (juce::Time::getHighResolutionTicks())
+        {
+            if (probe.resetPending.exchange (false))
+                probe.clear();
+        }
+
+        ~Scope()
+        {
+            const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+            exchangeCurrent (previous);
+            probe.record (juce::Time::highResolutionTicksToSeconds (ticks), budgetSeconds);
+        }
+
+    private:
+        SSLBlockProbe& probe;
+        const double budgetSeconds;
+        SSLBlockProbe* const previous;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    // Any thread.
+    void read (SSLBlockStats& stats) const noexcept
+    {
+        juce::int64 counts[numBins];
+        juce::int64 total = 0;
+
+        for (int bin = 0; bin < numBins; ++bin)
+            total += counts[bin] = histogram[bin].load (std::memory_order_relaxed);
+
+        stats.numBlocks = numBlocks.load (std::memory_order_relaxed);
+        stats.maxMicroseconds = maxSeconds.load (std::memory_order_relaxed) * 1.0e6;
+        stats.p50Microseconds = juce::jmin (stats.maxMicroseconds, getPercentile (counts, total, 0.5) * 1.0e6);
+        stats.p99Microseconds = juce::jmin (stats.maxMicroseconds, getPercentile (counts, total, 0.99) * 1.0e6);
+
+        const double audioSeconds = totalAudioSeconds.load (std::memory_order_relaxed);
+        stats.averageLoadPercent = audioSeconds > 0.0 ? 100.0 * totalSeconds.load (std::memory_order_relaxed) / audioSeconds : 0.0;
+        stats.peakLoadPercent = 100.0 * peakLoad.load (std::memory_order_relaxed);
+
+        stats.allocations = allocations.load (std::memory_order_relaxed);
+        stats.deallocations = deallocations.load (std::memory_order_relaxed);
+        stats.locks = locks.load (std::memory_order_relaxed);
+    }
+
+    // Any thread; the audio thread clears everything at the start of its next block.
+    void reset() noexcept
+    {
+        resetPending = true;
+    }
+
+    // Called by the hooks in Instrumentation.cpp, on whatever thread made the call.
+    static void countAllocation() noexcept;
+    static void countDeallocation() noexcept;
+    static void countLock() noexcept;
+
+private:
+    static SSLBlockProbe* exchangeCurrent (SSLBlockProbe* probe) noexcept;
+
+    // The audio thread is the only writer, so plain load/store pairs are enough
+    template <typename Type>
+    static void increment (std::atomic<Type>& counter, Type amount = 1) noexcept
+    {
+        counter.store (counter.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void record (double seconds, double budgetSeconds) noexcept
+    {
+        const double octaves = std::log2 (juce::jmax (1.0, seconds * 1.0e9 / minNanoseconds));
+        increment (histogram[juce::jmin (numBins - 1, (int) (octaves * binsPerOctave))], (juce::int64) 1);
+
+        increment (numBlocks, (juce::int64) 1);
+        increment (totalSeconds, seconds);
+        increment (totalAudioSeconds, budgetSeconds);
+        maxSeconds.store (juce::jmax (maxSeconds.load (std::memory_order_relaxed), seconds), std::memory_order_relaxed);
+
+        if (budgetSeconds > 0.0)
+            peakLoad.store (juce::jmax (peakLoad.load (std::memory_order_relaxed), seconds / budgetSeconds), std::memory_order_relaxed);
+    }
+
+    void clear() noexcept
+    {
+        for (auto& bin : histogram)
+            bin.store (0, std::memory_order_relaxed);
+
+        for (auto* counter : { &numBlocks, &allocations, &deallocations, &locks })
+            counter->store (0, std::memory_order_relaxed);
+
+        for (auto* value : { &totalSeconds, &totalAudioSeconds, &maxSeconds, &peakLoad })
+            value->store (0.0, std::memory_order_relaxed);
+    }
+
+    // Upper edge of the bin holding the given fraction of all blocks, in seconds
+    static double getPercentile (const juce::int64* counts, juce::int64 total, double fraction) noexcept
+    {
+        const auto target = (juce::int64) std::ceil (fraction * (double) total);
+        juce::int64 sum = 0;
+
+        for (int bin = 0; bin < numBins; ++bin)
+            if ((sum += counts[bin]) >= target && sum > 0)
+                return minNanoseconds * 1.0e-9 * std::exp2 ((bin + 1) / (double) binsPerOctave);
+
+        return 0.0;
+    }
+
+    std::atomic<juce::int64> histogram[numBins] {};
+    std::atomic<juce::int64> numBlocks { 0 }, allocations { 0 }, deallocations { 0 }, locks { 0 };
+    std::atomic<double> totalSeconds { 0.0 }, totalAudioSeconds { 0.0 }, maxSeconds { 0.0 }, peakLoad { 0.0 };
+    std::atomic<bool> resetPending { false };
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Describes how the channels of the main bus share detectors.
+//
+// Channels are split into link groups (for example fronts linked and LFE on
+// its own). Inside a group each channel's detector is blended towards the
+// group's combined level by the link amount. When the amount is 100 % every
+// channel of a group would see the same level, so the group runs a single
+// detector lane instead of one per channel.
+//
+// Detector lanes are identified by the index of the channel whose scratch lane
+// holds them, so per-lane state can be stored per channel.
+struct SSLLinkLayout
+{
+    static constexpr int maxChannels = 12;  // 7.1.4
+
+    enum class Groups
+    {
+        all = 0,
+        lfeIndependent,
+        frontsSurroundsHeights,
+        independent
+    };
+
+    int numChannels = 0;
+    int numGroups = 0;
+    int groupSize[maxChannels] {};
+    int groupChannels[maxChannels][maxChannels] {};
+
+    float linkAmount = 1.0f;
+    bool fullyLinked = true;            // one detector lane per group
+    int numLanes = 0;
+    int laneChannels[maxChannels] {};   // channel owning each active detector lane
+    int laneOfChannel[maxChannels] {};  // detector lane (as channel index) that scales each channel
+
+    // Allocation-free, so it can run on the audio thread when the settings change.
+    void update (const juce::AudioChannelSet::ChannelType* channelTypes, int newNumChannels,
+                 Groups groups, float newLinkAmount) noexcept
+    {
+        numChannels = juce::jlimit (0, maxChannels, newNumChannels);
+        linkAmount = juce::jlimit (0.0f, 1.0f, newLinkAmount);
+        numGroups = 0;
+
+        for (auto& size : groupSize)
+            size = 0;
+
+        int groupOfKind[3] = { -1, -1, -1 };  // fronts, surrounds, heights
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const int kind = getKind (channelTypes[channel], groups);
+            int group;
+
+            if (kind < 0)
+            {
+                group = numGroups++;
+            }
+            else
+            {
+                if (groupOfKind[kind] < 0)
+                    groupOfKind[kind] = numGroups++;
+
+                group = groupOfKind[kind];
+            }
+
+            groupChannels[group][groupSize[group]++] = channel;
+        }
+
+        fullyLinked = linkAmount >= 1.0f;
+        numLanes = 0;
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            for (int i = 0; i < groupSize[group]; ++i)
+            {
+                const int channel = groupChannels[group][i];
+                const int lane = fullyLinked ? groupChannels[group][0] : channel;
+
+                laneOfChannel[channel] = lane;
+
+                if (lane == channel)
+                    laneChannels[numLanes++] = channel;
+            }
+        }
+    }
+
+private:
+    // Link group kind for a channel, or -1 if it gets a group of its own.
+    static int getKind (juce::AudioChannelSet::ChannelType type, Groups groups) noexcept
+    {
+        using CS = juce::AudioChannelSet;
+
+        const bool isLfe = type == CS::LFE || type == CS::LFE2;
+
+        switch (groups)
+        {
+            case Groups::independent:
+                return -1;
+
+            case Groups::lfeIndependent:
+                return isLfe ? -1 : 0;
+
+            case Groups::frontsSurroundsHeights:
+                if (isLfe)
+                    return -1;
+
+                switch (type)
+                {
+                    case CS::leftSurround:      case CS::rightSurround:     case CS::centreSurround:
+                    case CS::leftSurroundSide:  case CS::rightSurroundSide:
+                    case CS::leftSurroundRear:  case CS::rightSurroundRear:
+                        return 1;
+
+                    case CS::topFrontLeft:      case CS::topFrontRight:     case CS::topFrontCentre:
+                    case CS::topMiddle:         case CS::topRearLeft:       case CS::topRearRight:
+                    case CS::topRearCentre:     case CS::topSideLeft:       case CS::topSideRight:
+                        return 2;
+
+                    default:
+                        return 0;
+                }
+
+            case Groups::all:
+            default:
+                return 0;
+        }
+    }
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Multichannel integer delay on power-of-two ring buffers. Used for the
+// lookahead audio path, and by the processor to keep the bypassed signal
+// aligned with the latency it reports.
+template <typename SampleType>
+class SSLDelayLine
+{
+public:
+    void prepare (int numChannels, int maxDelaySamples)
+    {
+        const int size = juce::nextPowerOfTwo (juce::jmax (1, maxDelaySamples) + 1);
+
+        mask = size - 1;
+        lines.setSize (numChannels, size);
+        delaySamples = 0;
+
+        reset();
+    }
+
+    void release()
+    {
+        lines.setSize (0, 0);
+        mask = 0;
+        delaySamples = 0;
+    }
+
+    void reset() noexcept
+    {
+        lines.clear();
+        writePosition = 0;
+    }
+
+    // Must not exceed the maxDelaySamples passed to prepare().
+    void setDelay (int newDelaySamples) noexcept
+    {
+        jassert (newDelaySamples >= 0 && newDelaySamples <= mask);
+        delaySamples = juce::jlimit (0, mask, newDelaySamples);
+    }
+
+    int getDelay() const noexcept               { return delaySamples; }
+
+    // Delays every channel of the block in place.
+    void process (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        jassert ((int) block.getNumChannels() <= lines.getNumChannels());
+
+        const auto numSamples = (int) block.getNumSamples();
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto* line = lines.getWritePointer ((int) channel);
+            auto* data = block.getChannelPointer (channel);
+            int write = writePosition;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                line[write] = data[i];
+                data[i] = line[(write - delaySamples) & mask];
+                write = (write + 1) & mask;
+            }
+        }
+
+        writePosition = (writePosition + numSamples) & mask;
+    }
+
+private:
+    juce::AudioBuffer<SampleType> lines;
+    int mask = 0, writePosition = 0, delaySamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SSLDelayLine)
+};
+
+//==============================================================================
+// Lookahead for SSLCompressorAudioProcessor: delays the audio by N samples and
+// replaces each detector lane by its maximum over the last N + 1 samples, so
+// the envelope already sees a peak N samples before it reaches the output.
+//
+// The maximum uses a monotonic deque per detector lane (values strictly
+// decreasing from front to back), which costs O(1) amortised per sample
+// whatever the window length. Lanes are indexed like the channels, or by the
+// caller's own scheme when there are several detectors per channel.
+// All storage is sized in prepare(); nothing here allocates while processing.
+template <typename SampleType>
+class SSLLookahead
+{
+public:
+    void prepare (int numChannels, int maxDelaySamples)
+    {
+        const int size = juce::nextPowerOfTwo (juce::jmax (1, maxDelaySamples) + 1);
+
+        mask = size - 1;
+        audioDelay.prepare (numChannels, maxDelaySamples);
+        entries.allocate ((size_t) (numChannels * size), true);
+        windows.allocate ((size_t) numChannels, true);
+        numWindows = numChannels;
+        delaySamples = 0;
+
+        reset();
+    }
+
+    void release()
+    {
+        audioDelay.release();
+        entries.free();
+        windows.free();
+        numWindows = 0;
+        mask = 0;
+        delaySamples = 0;
+    }
+
+    void reset() noexcept
+    {
+        audioDelay.reset();
+        resetDetectors();
+    }
+
+    // Forgets the detector history, e.g. when the lanes are remapped.
+    void resetDetectors() noexcept
+    {
+        for (int lane = 0; lane < numWindows; ++lane)
+            windows[lane] = {};
+    }
+
+    // Must not exceed the maxDelaySamples passed to prepare().
+    void setDelay (int newDelaySamples) noexcept
+    {
+        jassert (newDelaySamples >= 0 && newDelaySamples <= mask);
+
+        if (newDelaySamples != delaySamples)
+        {
+            delaySamples = juce::jlimit (0, mask, newDelaySamples);
+            audioDelay.setDelay (delaySamples);
+            resetDetectors();
+        }
+    }
+
+    int getDelay() const noexcept               { return delaySamples; }
+
+    //==============================================================================
+    // In place: data[i] = max (data[i - delay] .. data[i]), carrying the lane's window across calls.
+    // 'stride' steps through one detector of an interleaved buffer.
+    void processDetector (int lane, SampleType* data, int numSamples, int stride = 1) noexcept
+    {
+        jassert (lane >= 0 && lane < numWindows);
+
+        auto& window = windows[lane];
+        auto* laneEntries = entries + lane * (mask + 1);
+        const auto windowStart = (juce::int64) delaySamples;
+
+        auto position = window.position;
+        auto head = window.head, tail = window.tail;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType value = data[i * stride];
+
+            // Anything not larger than the new value can never be the maximum again
+            while (tail != head && laneEntries[(tail - 1) & mask].value <= value)
+                --tail;
+
+            laneEntries[tail++ & mask] = { position, value };
+
+            while (laneEntries[head & mask].position < position - windowStart)
+                ++head;
+
+            data[i * stride] = laneEntries[head & mask].value;
+            ++position;
+        }
+
+        window.position = position;
+        window.head = head;
+        window.tail = tail;
+    }
+
+    // Delays every channel of the block by the current lookahead.
+    void processAudio (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        audioDelay.process (block);
+    }
+
+private:
+    struct Entry
+    {
+        juce::int64 position;
+        SampleType value;
+    };
+
+    struct Window
+    {
+        juce::int64 position = 0;
+        unsigned int head = 0, tail = 0;
+    };
+
+    SSLDelayLine<SampleType> audioDelay;
+    juce::HeapBlock<Entry> entries;
+    juce::HeapBlock<Window> windows;
+    int numWindows = 0;
+    int mask = 0, delaySamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SSLLookahead)
+};
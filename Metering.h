@@ -0,0 +1,281 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Metering pipeline from the audio thread to the editor.
+//
+// The audio thread measures fixed-length frames (SSLMeterAccumulator) and
+// pushes each finished frame into a wait-free single-producer/single-consumer
+// ring (SSLMeterFifo). The editor drains the ring on its timer into a
+// fixed-size history (SSLMeterHistory). Frames cover a fixed time span whatever
+// the host block size, and the editor consumes every frame whatever its timer
+// rate, so the meters don't depend on either.
+
+// One meter frame. Levels are linear, gain reduction is in dB (<= 0) and
+// excludes the makeup gain.
+struct SSLMeterFrame
+{
+    float inputPeak = 0.0f, inputRms = 0.0f;
+    float outputPeak = 0.0f, outputRms = 0.0f;
+    float gainReductionPeakDb = 0.0f;   // deepest reduction in the frame
+    float gainReductionRmsDb = 0.0f;    // reduction of the frame's mean gain power
+    float seconds = 0.0f;               // time span covered
+};
+
+//==============================================================================
+// Wait-free SPSC ring of meter frames: the audio thread pushes, the editor pops.
+// When the editor falls behind by more than the capacity, new frames are dropped
+// rather than blocking the audio thread, so a reader that has not been reading
+// (no editor, or a hidden one) discards the backlog before it starts again.
+class SSLMeterFifo
+{
+public:
+    static constexpr int capacity = 1024;  // about 10 s of 10 ms frames
+
+    // Audio thread only.
+    bool push (const SSLMeterFrame& frame) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        frames[size1 > 0 ? start1 : start2] = frame;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    // Message thread only. Returns the number of frames copied to dest.
+    int pop (SSLMeterFrame* dest, int maxFrames) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (maxFrames, start1, size1, start2, size2);
+
+        std::copy (frames + start1, frames + start1 + size1, dest);
+        std::copy (frames + start2, frames + start2 + size2, dest + size1);
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    // Message thread only. Drops every pending frame.
+    void discard() noexcept
+    {
+        fifo.finishedRead (fifo.getNumReady());
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    SSLMeterFrame frames[capacity];
+
+    JUCE_DECLARE_NON_COPYABLE (SSLMeterFifo)
+};
+
+//==============================================================================
+// Audio-thread side: accumulates segments of processed audio into frames of
+// a fixed duration. The caller splits its blocks with getSamplesUntilFrame()
+// so a segment never crosses a frame boundary.
+//
+// Frames are for display and hold floats whatever the sample type; sums are
+// kept in double, and the peak addInput() returns keeps the sample's value.
+class SSLMeterAccumulator
+{
+public:
+    static constexpr double frameSeconds = 0.01;
+
+    void prepare (double sampleRate) noexcept
+    {
+        frameLength = juce::jmax (1, juce::roundToInt (sampleRate * frameSeconds));
+        frameDuration = (float) (frameLength / sampleRate);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        position = 0;
+        inputPeak = outputPeak = 0.0f;
+        inputSquares = outputSquares = gainSquares = 0.0;
+        minGainReductionDb = 0.0f;
+        numLevelValues = numGainValues = 0;
+    }
+
+    int getSamplesUntilFrame() const noexcept   { return frameLength - position; }
+
+    // Returns the block's peak, which the processor reuses for its idle check.
+    template <typename SampleType>
+    double addInput (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        lastInput = measure (block);
+        inputPeak = juce::jmax (inputPeak, (float) lastInput.peak);
+        inputSquares += lastInput.squares;
+        numLevelValues += (int) (block.getNumChannels() * block.getNumSamples());
+        return lastInput.peak;
+    }
+
+    template <typename SampleType>
+    void addOutput (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        addOutputLevel (measure (block));
+    }
+
+    // The output is the block passed to the last addInput, unchanged.
+    void addUnchangedOutput() noexcept
+    {
+        addOutputLevel (lastInput);
+    }
+
+    // One detector lane's linear gain, including the makeup gain given in dB.
+    template <typename SampleType>
+    void addGain (const SampleType* gain, int numSamples, SampleType makeupDb) noexcept
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax (gain, numSamples);
+        minGainReductionDb = juce::jmin (minGainReductionDb,
+                                         (float) (juce::Decibels::gainToDecibels (range.getStart(), (SampleType) -100) - makeupDb));
+
+        gainSquares += sumOfSquares (gain, numSamples) * std::pow (10.0, -0.1 * makeupDb);
+        numGainValues += numSamples;
+    }
+
+    // Same as addGain for a lane of exactly 1 with 0 dB makeup, without reading it.
+    void addUnityGain (int numSamples) noexcept
+    {
+        gainSquares += numSamples;
+        numGainValues += numSamples;
+    }
+
+    // Call after each segment. Returns true and fills 'frame' when the segment completed one.
+    bool advance (int numSamples, SSLMeterFrame& frame) noexcept
+    {
+        position += numSamples;
+        jassert (position <= frameLength);
+
+        if (position < frameLength)
+            return false;
+
+        const auto levelScale = 1.0 / juce::jmax (1, numLevelValues);
+        const auto meanGainPower = numGainValues > 0 ? gainSquares / numGainValues : 1.0;
+
+        frame.inputPeak = inputPeak;
+        frame.inputRms = (float) std::sqrt (inputSquares * levelScale);
+        frame.outputPeak = outputPeak;
+        frame.outputRms = (float) std::sqrt (outputSquares * levelScale);
+        frame.gainReductionPeakDb = juce::jmin (0.0f, minGainReductionDb);
+        frame.gainReductionRmsDb = juce::jmin (0.0f, (float) (10.0 * std::log10 (juce::jmax (1.0e-10, meanGainPower))));
+        frame.seconds = frameDuration;
+
+        reset();
+        return true;
+    }
+
+private:
+    template <typename SampleType>
+    static double sumOfSquares (const SampleType* data, int numSamples) noexcept
+    {
+        SampleType sum = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+            sum += data[i] * data[i];
+
+        return sum;
+    }
+
+    struct Level
+    {
+        double peak = 0.0;
+        double squares = 0.0;
+    };
+
+    template <typename SampleType>
+    static Level measure (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        const auto numSamples = (int) block.getNumSamples();
+        Level level;
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            const auto* data = block.getChannelPointer (channel);
+            const auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+
+            level.peak = juce::jmax (level.peak, (double) -range.getStart(), (double) range.getEnd());
+            level.squares += sumOfSquares (data, numSamples);
+        }
+
+        return level;
+    }
+
+    void addOutputLevel (const Level& level) noexcept
+    {
+        outputPeak = juce::jmax (outputPeak, (float) level.peak);
+        outputSquares += level.squares;
+    }
+
+    int frameLength = 1, position = 0;
+    float frameDuration = 0.0f;
+    float inputPeak = 0.0f, outputPeak = 0.0f, minGainReductionDb = 0.0f;
+    double inputSquares = 0.0, outputSquares = 0.0, gainSquares = 0.0;
+    int numLevelValues = 0, numGainValues = 0;
+    Level lastInput;
+};
+
+//==============================================================================
+// Editor side: the most recent frames plus VU ballistics, updated per frame so
+// the needle moves the same whatever the timer rate.
+class SSLMeterHistory
+{
+public:
+    static constexpr int size = 512;               // about 5 s of 10 ms frames
+    static constexpr float vuTimeSeconds = 0.3f;   // VU integration time
+
+    // Moves every pending frame from the fifo into the history. Returns the number of new frames.
+    int drain (SSLMeterFifo& fifo) noexcept
+    {
+        SSLMeterFrame pending[64];
+        int total = 0;
+
+        while (const int numRead = fifo.pop (pending, (int) juce::numElementsInArray (pending)))
+        {
+            for (int i = 0; i < numRead; ++i)
+                add (pending[i]);
+
+            total += numRead;
+        }
+
+        return total;
+    }
+
+    void clear() noexcept
+    {
+        std::fill (std::begin (frames), std::end (frames), SSLMeterFrame {});
+        newest = 0;
+        numFrames = 0;
+        vuGainReductionDb = 0.0f;
+    }
+
+    int getNumFrames() const noexcept                   { return numFrames; }
+
+    // age 0 is the newest frame, getNumFrames() - 1 the oldest.
+    const SSLMeterFrame& getFrame (int age) const noexcept
+    {
+        jassert (age >= 0 && age < size);
+        return frames[(newest - age + size) % size];
+    }
+
+    float getVuGainReductionDb() const noexcept         { return vuGainReductionDb; }
+
+private:
+    void add (const SSLMeterFrame& frame) noexcept
+    {
+        newest = (newest + 1) % size;
+        frames[newest] = frame;
+        numFrames = juce::jmin (numFrames + 1, size);
+
+        const float coeff = std::exp (-frame.seconds / vuTimeSeconds);
+        vuGainReductionDb = coeff * vuGainReductionDb + (1.0f - coeff) * frame.gainReductionRmsDb;
+    }
+
+    SSLMeterFrame frames[size];
+    int newest = 0, numFrames = 0;
+    float vuGainReductionDb = 0.0f;
+};
\ No newline at end of file
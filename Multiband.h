@@ -0,0 +1,358 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "CompressorKernel.h"
+
+//==============================================================================
+// Multiband mode: Linkwitz-Riley crossovers split the input into two to four
+// bands, every band goes through the detector, static curve and envelope of
+// the full-band kernel, and the compressed bands are summed back.
+//
+// Per-band detector data is interleaved with the bands innermost, always
+// maxBands wide: levels[sample * maxBands + band] for each detector lane, and
+// envelope[lane][band] in the state. The dB conversions then run once over all
+// bands of a lane, and the curve and envelope recursion advance the bands of a
+// lane together, four independent chains per sample that fit one SIMD register,
+// instead of one band after the other. Unused band slots carry silence and
+// settle at 0 dB.
+
+// Crossover tree of fourth-order Linkwitz-Riley filters, each built from two
+// Butterworth TPT state-variable sections (as juce::dsp::LinkwitzRileyFilter).
+// Crossover k splits band k into band k and band k + 1; the bands below it get
+// the matching second-order allpass, so the bands always sum to an allpassed
+// copy of the input with a flat magnitude response.
+// All storage is sized in prepare(); nothing here allocates while processing.
+template <typename SampleType>
+class SSLCrossover
+{
+public:
+    static constexpr int maxBands = 4;
+    static constexpr int maxCrossovers = maxBands - 1;
+
+    void prepare (int numChannels)
+    {
+        states.allocate ((size_t) numChannels, true);
+        numStates = numChannels;
+    }
+
+    void release()
+    {
+        states.free();
+        numStates = 0;
+    }
+
+    void reset() noexcept
+    {
+        for (int channel = 0; channel < numStates; ++channel)
+            states[channel] = {};
+    }
+
+    // numCrossovers = bands - 1, frequencies in Hz. Out-of-order frequencies are
+    // raised to the one below, and everything stays under Nyquist.
+    void setFrequencies (const float* frequencies, int numCrossovers, double sampleRate) noexcept
+    {
+        jassert (numCrossovers >= 0 && numCrossovers <= maxCrossovers);
+        numSplits = juce::jlimit (0, maxCrossovers, numCrossovers);
+
+        double previous = 0.0;
+
+        for (int k = 0; k < numSplits; ++k)
+        {
+            previous = juce::jlimit (previous, 0.45 * sampleRate, (double) frequencies[k]);
+            sections[k].setFrequency (previous, sampleRate);
+        }
+    }
+
+    int getNumBands() const noexcept        { return numSplits + 1; }
+
+    // Splits every channel of the block into bands[band * numChannels + channel].
+    void process (const juce::dsp::AudioBlock<SampleType>& block, SampleType* const* bands) noexcept
+    {
+        const auto numChannels = (int) block.getNumChannels();
+        const auto numSamples = (int) block.getNumSamples();
+        jassert (numChannels <= numStates);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* input = block.getChannelPointer ((size_t) channel);
+            SampleType* band[maxBands];
+
+            for (int i = 0; i <= numSplits; ++i)
+                band[i] = bands[i * numChannels + channel];
+
+            switch (numSplits)
+            {
+                case 0:  juce::FloatVectorOperations::copy (band[0], input, numSamples); break;
+                case 1:  processChannel<1> (input, band, states[channel], numSamples); break;
+                case 2:  processChannel<2> (input, band, states[channel], numSamples); break;
+                default: processChannel<3> (input, band, states[channel], numSamples); break;
+            }
+        }
+    }
+
+private:
+    struct Section
+    {
+        void setFrequency (double frequency, double sampleRate) noexcept
+        {
+            const auto g0 = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+
+            g = (SampleType) g0;
+            r2PlusG = (SampleType) (juce::MathConstants<double>::sqrt2 + g0);
+            h = (SampleType) (1.0 / (1.0 + juce::MathConstants<double>::sqrt2 * g0 + g0 * g0));
+        }
+
+        void split (SampleType input, SampleType& low, SampleType& high, SampleType* z) const noexcept
+        {
+            const SampleType yH = (input - r2PlusG * z[0] - z[1]) * h;
+            const SampleType yB = g * yH + z[0];
+            z[0] = g * yH + yB;
+            const SampleType yL = g * yB + z[1];
+            z[1] = g * yB + yL;
+
+            const SampleType yH2 = (yL - r2PlusG * z[2] - z[3]) * h;
+            const SampleType yB2 = g * yH2 + z[2];
+            z[2] = g * yH2 + yB2;
+            const SampleType yL2 = g * yB2 + z[3];
+            z[3] = g * yB2 + yL2;
+
+            low = yL2;
+            high = yL - r2 * yB + yH - yL2;
+        }
+
+        // The allpass the two outputs of split() sum to
+        SampleType allpass (SampleType input, SampleType* z) const noexcept
+        {
+            const SampleType yH = (input - r2PlusG * z[0] - z[1]) * h;
+            const SampleType yB = g * yH + z[0];
+            z[0] = g * yH + yB;
+            const SampleType yL = g * yB + z[1];
+            z[1] = g * yB + yL;
+
+            return yL - r2 * yB + yH;
+        }
+
+        static constexpr auto r2 = (SampleType) juce::MathConstants<double>::sqrt2;
+        SampleType g = 0, r2PlusG = 0, h = 0;
+    };
+
+    struct ChannelState
+    {
+        SampleType split[maxCrossovers][4];
+        SampleType allpass[maxCrossovers][maxCrossovers - 1][2];   // [crossover][band below it]
+    };
+
+    // The whole tree runs in one pass per sample. Each filter on its own is a
+    // chain of dependent multiply-adds, so running them one after the other over
+    // the block waits on latency; in one loop the chains of neighbouring samples
+    // overlap. The local copy of the state lets the compiler keep it in registers.
+    template <int numCrossovers>
+    void processChannel (const SampleType* input, SampleType* const* band, ChannelState& channelState, int numSamples) const noexcept
+    {
+        auto state = channelState;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            SampleType out[maxBands];
+            SampleType rest = input[i];
+
+            for (int k = 0; k < numCrossovers; ++k)
+            {
+                sections[k].split (rest, out[k], rest, state.split[k]);
+
+                for (int lower = 0; lower < k; ++lower)
+                    out[lower] = sections[k].allpass (out[lower], state.allpass[k][lower]);
+            }
+
+            out[numCrossovers] = rest;
+
+            for (int b = 0; b <= numCrossovers; ++b)
+                band[b][i] = out[b];
+        }
+
+        channelState = state;
+    }
+
+    Section sections[maxCrossovers];
+    juce::HeapBlock<ChannelState> states;
+    int numStates = 0, numSplits = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SSLCrossover)
+};
+
+//==============================================================================
+// Per-band recursive state, indexed [detector lane][band].
+template <typename SampleType>
+struct SSLMultibandState
+{
+    static constexpr int maxBands = SSLCrossover<SampleType>::maxBands;
+
+    SampleType envelope[SSLLinkLayout::maxChannels][maxBands] {};
+    SampleType held[SSLLinkLayout::maxChannels][maxBands] {};
+    SampleType meanSquare[SSLLinkLayout::maxChannels][maxBands] {};
+
+    void reset() noexcept      { *this = {}; }
+};
+
+// The full-band context plus the band buffers. The lookahead, when set, holds
+// one detector window per lane and band (lane * maxBands + band) and one audio
+// line per band channel.
+template <typename SampleType>
+struct SSLMultibandContext  : SSLKernelContext<SampleType>
+{
+    SSLCrossover<SampleType>* crossover;
+    SampleType* const* bands;          // bands[band * numChannels + channel], one lane each
+    SampleType* const* bandLevels;     // per detector lane, numSamples * maxBands interleaved values
+};
+
+//==============================================================================
+// One call splits and compresses every band of every channel and sums the bands
+// back into the block. Afterwards each detector lane holds the gain of its most
+// reduced band, for the meters.
+template <typename SampleType, typename Detection, typename Topology, typename Knee, typename Link>
+struct SSLMultibandKernel
+{
+    static constexpr int maxBands = SSLCrossover<SampleType>::maxBands;
+
+    static void process (const juce::dsp::AudioBlock<SampleType>& block, SSLMultibandState<SampleType>& state,
+                         const SSLMultibandContext<SampleType>& context) noexcept
+    {
+        const auto& link = *context.link;
+        const int numSamples = (int) block.getNumSamples();
+        const int numBandChannels = (int) block.getNumChannels();
+        const int numChannels = juce::jmin (numBandChannels, link.numChannels);
+        const int numBands = context.crossover->getNumBands();
+
+        context.crossover->process (block, context.bands);
+
+        // Band magnitudes, linked like the full-band kernel links channels, interleaved per lane
+        for (int band = 0; band < maxBands; ++band)
+        {
+            if (band < numBands)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    Detection::magnitude (context.lanes[channel], context.bands[band * numBandChannels + channel], numSamples);
+
+                SSLCompressorKernel<SampleType, Detection, Topology, Knee, Link>::linkChannels (link, context, numSamples);
+            }
+
+            for (int i = 0; i < link.numLanes; ++i)
+            {
+                const int lane = link.laneChannels[i];
+                const SampleType* source = context.lanes[lane];
+                SampleType* levels = context.bandLevels[lane] + band;
+
+                if (band < numBands)
+                    for (int s = 0; s < numSamples; ++s)
+                        levels[s * maxBands] = source[s];
+                else
+                    for (int s = 0; s < numSamples; ++s)
+                        levels[s * maxBands] = 0;
+            }
+        }
+
+        for (int i = 0; i < link.numLanes; ++i)
+        {
+            const int lane = link.laneChannels[i];
+            SampleType* levels = context.bandLevels[lane];
+            const int numValues = numSamples * maxBands;
+
+            Detection::template levels<maxBands> (levels, numSamples, state.meanSquare[lane], context.rmsCoeff);
+
+            if (context.lookahead != nullptr)
+                for (int band = 0; band < numBands; ++band)
+                    context.lookahead->processDetector (lane * maxBands + band, levels + band, numSamples, maxBands);
+
+            SSLGainComputer::levelToDecibels (levels, numValues, context.math);
+            computeGains (levels, state.envelope[lane], state.held[lane], context, numSamples);
+
+            for (auto& envelope : state.envelope[lane])
+                SSLGainComputer::settleEnvelope (envelope);
+
+            for (auto& hold : state.held[lane])
+                SSLGainComputer::settleHold (hold);
+
+            context.math.decibelsToGain (levels, numValues);
+        }
+
+        if (context.lookahead != nullptr)
+            context.lookahead->processAudio (juce::dsp::AudioBlock<SampleType> (context.bands, (size_t) (numBands * numBandChannels),
+                                                                                (size_t) numSamples));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            SampleType* output = block.getChannelPointer ((size_t) channel);
+            const SampleType* gains = context.bandLevels[link.laneOfChannel[channel]];
+            const SampleType* input = context.bands[channel];
+
+            for (int s = 0; s < numSamples; ++s)
+                output[s] = input[s] * gains[s * maxBands];
+
+            for (int band = 1; band < numBands; ++band)
+            {
+                input = context.bands[band * numBandChannels + channel];
+
+                for (int s = 0; s < numSamples; ++s)
+                    output[s] += input[s] * gains[s * maxBands + band];
+            }
+        }
+
+        for (int i = 0; i < link.numLanes; ++i)
+        {
+            const int lane = link.laneChannels[i];
+            const SampleType* gains = context.bandLevels[lane];
+            SampleType* dest = context.lanes[lane];
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                SampleType gain = gains[s * maxBands];
+
+                for (int band = 1; band < numBands; ++band)
+                    gain = juce::jmin (gain, gains[s * maxBands + band]);
+
+                dest[s] = gain;
+            }
+        }
+    }
+
+private:
+    // Curve, envelope and makeup for all bands of one lane. The band loop has a
+    // fixed width and only selects, so it can map onto one vector per sample;
+    // compiled as scalars the four recursions still overlap in the pipeline.
+    static void computeGains (SampleType* levels, SampleType* envelope, SampleType* held, const SSLKernelContext<SampleType>& context, int numSamples) noexcept
+    {
+        SampleType env[maxBands], hold[maxBands];
+        std::copy (envelope, envelope + maxBands, env);
+        std::copy (held, held + maxBands, hold);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            SampleType* frame = levels + i * maxBands;
+
+            for (int band = 0; band < maxBands; ++band)
+            {
+                const SampleType target = Knee::curve (Topology::detectorLevel (frame[band], env[band]) - context.thresholdDb[i],
+                                                       context.slope[i], context.kneeDb);
+                env[band] = SSLGainComputer::smooth (env[band], hold[band], target, context.ballistics);
+                frame[band] = env[band] + context.makeupDb[i];
+            }
+        }
+
+        std::copy (env, env + maxBands, envelope);
+        std::copy (hold, hold + maxBands, held);
+    }
+};
+
+//==============================================================================
+struct SSLMultibandKernels
+{
+    template <typename SampleType>
+    using ProcessFunction = void (*) (const juce::dsp::AudioBlock<SampleType>&, SSLMultibandState<SampleType>&, const SSLMultibandContext<SampleType>&);
+
+    template <typename SampleType>
+    static ProcessFunction<SampleType> select (SSLCompressorKernels::Detection detection, SSLCompressorKernels::Topology topology,
+                                               bool softKnee, SSLCompressorKernels::StereoLink link) noexcept
+    {
+        return SSLCompressorKernels::selectFor<SSLMultibandKernel, SampleType> (detection, topology, softKnee, link);
+    }
+};
\ No newline at end of file
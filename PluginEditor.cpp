@@ -2,17 +2,17 @@
 #include "PluginEditor.h"
 
 //==============================================================================
-SSLCompAudioProcessorEditor::SSLCompAudioProcessorEditor (SSLCompAudioProcessor& p)
+SSLCompressorAudioProcessorEditor::SSLCompressorAudioProcessorEditor (SSLCompressorAudioProcessor& p)
     : AudioProcessorEditor (&p), processorRef (p)
 {
     // --- GUI Element Setup ---
 
     // Setup sliders using the helper function
-    setupSlider(thresholdSlider, thresholdLabel, "Threshold", SSLCompAudioProcessor::PARAM_THRESHOLD, thresholdAttachment);
-    setupSlider(ratioSlider, ratioLabel, "Ratio", SSLCompAudioProcessor::PARAM_RATIO, ratioAttachment, true); // Ratio is stepped
-    setupSlider(attackSlider, attackLabel, "Attack", SSLCompAudioProcessor::PARAM_ATTACK, attackAttachment);
-    setupSlider(releaseSlider, releaseLabel, "Release", SSLCompAudioProcessor::PARAM_RELEASE, releaseAttachment);
-    setupSlider(makeupSlider, makeupLabel, "Makeup", SSLCompAudioProcessor::PARAM_MAKEUP, makeupAttachment);
+    setupSlider(thresholdSlider, thresholdLabel, "Threshold", SSLCompressorAudioProcessor::PARAM_THRESHOLD, thresholdAttachment);
+    setupSlider(ratioSlider, ratioLabel, "Ratio", SSLCompressorAudioProcessor::PARAM_RATIO, ratioAttachment, true); // Ratio is stepped
+    setupSlider(attackSlider, attackLabel, "Attack", SSLCompressorAudioProcessor::PARAM_ATTACK, attackAttachment);
+    setupSlider(releaseSlider, releaseLabel, "Release", SSLCompressorAudioProcessor::PARAM_RELEASE, releaseAttachment);
+    setupSlider(makeupSlider, makeupLabel, "Makeup", SSLCompressorAudioProcessor::PARAM_MAKEUP, makeupAttachment);
 
 
     // Setup Bypass ("IN") Button
@@ -40,28 +40,67 @@ SSLCompAudioProcessorEditor::SSLCompAudioProcessorEditor (SSLCompAudioProcessor&
     bypassButton.setColour(juce::TextButton::textColourOffId, juce::Colours::black);     // Text colour when OFF (Active / IN)
 
     bypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        processorRef.parameters, SSLCompAudioProcessor::PARAM_BYPASS, bypassButton);
+        processorRef.parameters, SSLCompressorAudioProcessor::PARAM_BYPASS, bypassButton);
 
     addAndMakeVisible(bypassButton);
 
-    // Add VU Meter
+    // Preset menu: the processor's factory bank, recalled through the same path the host uses
+    for (int index = 0; index < processorRef.getNumPrograms(); ++index)
+        presetBox.addItem(processorRef.getProgramName(index), index + 1);
+
+    presetBox.setSelectedId(processorRef.getCurrentProgram() + 1, juce::dontSendNotification);
+    presetBox.onChange = [this]
+    {
+        processorRef.setCurrentProgram(presetBox.getSelectedId() - 1);
+        processorRef.updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    };
+    addAndMakeVisible(presetBox);
+
+    // A/B compare: the two slot buttons form a radio group, Copy puts the live settings into the other slot
+    for (auto* button : { &compareAButton, &compareBButton })
+    {
+        button->setClickingTogglesState(true);
+        button->setRadioGroupId(1);
+        button->setColour(juce::TextButton::buttonOnColourId, juce::Colours::yellow);
+        button->setColour(juce::TextButton::textColourOnId, juce::Colours::black);
+        addAndMakeVisible(button);
+    }
+
+    compareAButton.setToggleState(processorRef.getCompareSlot() == 0, juce::dontSendNotification);
+    compareBButton.setToggleState(processorRef.getCompareSlot() == 1, juce::dontSendNotification);
+    compareAButton.onClick = [this] { if (compareAButton.getToggleState()) processorRef.selectCompareSlot(0); };
+    compareBButton.onClick = [this] { if (compareBButton.getToggleState()) processorRef.selectCompareSlot(1); };
+    compareCopyButton.onClick = [this] { processorRef.copyToOtherCompareSlot(); };
+    addAndMakeVisible(compareCopyButton);
+
+   #if SSL_INSTRUMENTATION
+    blockStatsLabel.setFont(resources->smallFont);
+    blockStatsLabel.setJustificationType(juce::Justification::centredRight);
+    blockStatsLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(blockStatsLabel);
+   #endif
+
+    // Add VU Meter and the scrolling gain reduction graph
     addAndMakeVisible(vuMeter);
+    addAndMakeVisible(gainReductionGraph);
 
     // --- Editor Setup ---
-    setSize (480, 200); // Adjusted size slightly
-    startTimerHz(30); // Start timer for VU meter updates (e.g., 30 times per second)
+    setSize (480, 290); // Extra height for the preset bar and the gain reduction graph
+    processorRef.getMeterFifo().discard(); // Whatever queued up while no editor was open is stale
+    startTimerHz(meterRateHz); // Meter updates; the first tick drops the rate if the editor is not on screen
 }
 
-SSLCompAudioProcessorEditor::~SSLCompAudioProcessorEditor()
+SSLCompressorAudioProcessorEditor::~SSLCompressorAudioProcessorEditor()
 {
     stopTimer(); // Stop the timer when the editor is destroyed
 }
 
 // Helper function to reduce code duplication
-void SSLCompAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& text, const juce::StringRef paramID,
+void SSLCompressorAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& text, const juce::StringRef paramID,
                                            std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>& attachment, bool isStepped)
 {
     slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    slider.setLookAndFeel(&lookAndFeel);
     // Correct arguments for setTextBoxStyle
     slider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     slider.setColour(juce::Slider::thumbColourId, juce::Colours::lightgrey);
@@ -72,8 +111,7 @@ void SSLCompAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label&
     attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(processorRef.parameters, paramID, slider);
 
     label.setText(text, juce::dontSendNotification);
-    // Use updated Font constructor
-    label.setFont(juce::Font(juce::FontOptions(12.0f)));
+    label.setFont(resources->labelFont);
     label.setJustificationType(juce::Justification::centred);
     // Attach label below the slider
     label.attachToComponent(&slider, false);
@@ -85,7 +123,7 @@ void SSLCompAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label&
 
 
 //==============================================================================
-void SSLCompAudioProcessorEditor::paint (juce::Graphics& g)
+void SSLCompressorAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // Background
     g.fillAll (juce::Colour(0xff5a5a5a)); // SSL-ish grey background
@@ -96,11 +134,28 @@ void SSLCompAudioProcessorEditor::paint (juce::Graphics& g)
     // g.drawFittedText ("SSL Style Compressor", getLocalBounds().reduced(10).removeFromTop(20), juce::Justification::centred, 1);
 }
 
-void SSLCompAudioProcessorEditor::resized()
+void SSLCompressorAudioProcessorEditor::resized()
 {
     // Simple grid-like layout
     auto bounds = getLocalBounds().reduced(10); // Add some margin
 
+    // Preset bar along the top
+    auto presetBar = bounds.removeFromTop(20);
+    presetBox.setBounds(presetBar.removeFromLeft(200));
+    presetBar.removeFromLeft(10);
+    compareAButton.setBounds(presetBar.removeFromLeft(30));
+    compareBButton.setBounds(presetBar.removeFromLeft(30));
+    presetBar.removeFromLeft(5);
+    compareCopyButton.setBounds(presetBar.removeFromLeft(50));
+   #if SSL_INSTRUMENTATION
+    blockStatsLabel.setBounds(presetBar);
+   #endif
+    bounds.removeFromTop(10);
+
+    // Gain reduction graph along the bottom
+    gainReductionGraph.setBounds(bounds.removeFromBottom(50));
+    bounds.removeFromBottom(10);
+
     int sliderWidth = 70;
     int sliderHeight = 70;
     int labelHeight = 20; // Height reserved below slider for label
@@ -168,12 +223,276 @@ void SSLCompAudioProcessorEditor::resized()
 
 
 //==============================================================================
-void SSLCompAudioProcessorEditor::timerCallback()
+void SSLCompressorAudioProcessorEditor::timerCallback()
 {
-    // Get the gain reduction from the processor and update the VU meter
-    float gainReduction = processorRef.getCurrentGainReductionDb();
-    vuMeter.setLevelDb(gainReduction);
+    updateTimerRate();
+
+    // Take every frame published since the last tick, so the meters are right at any timer rate.
+    // A hidden editor keeps draining too, so the fifo never backs up with old frames.
+    if (meterHistory.drain(processorRef.getMeterFifo()) > 0)
+        metersOutOfDate = true;
+
+    if (! isShowing())
+        return;
+
+    if (metersOutOfDate)
+    {
+        vuMeter.setLevelDb(meterHistory.getVuGainReductionDb());
+        gainReductionGraph.update();
+        metersOutOfDate = false;
+    }
+
+    // Hosts change programs and reload state behind the editor's back
+    if (presetBox.getSelectedId() != processorRef.getCurrentProgram() + 1)
+        presetBox.setSelectedId(processorRef.getCurrentProgram() + 1, juce::dontSendNotification);
+
+    if (compareBButton.getToggleState() != (processorRef.getCompareSlot() == 1))
+        (processorRef.getCompareSlot() == 1 ? compareBButton : compareAButton).setToggleState(true, juce::dontSendNotification);
+
+   #if SSL_INSTRUMENTATION
+    SSLBlockStats stats;
+
+    if (processorRef.getBlockStats(stats))
+    {
+        blockStatsLabel.setText("p99 " + juce::String(stats.p99Microseconds, 0) + " us, " + juce::String(stats.averageLoadPercent, 1) + " %"
+                                    + (stats.isRealtimeSafe() ? juce::String() : " UNSAFE"), juce::dontSendNotification);
+    }
+   #endif
 
     // Optional: Could force repaint of button if appearance depends on factors other than toggle state
     // bypassButton.repaint();
+}
+
+void SSLCompressorAudioProcessorEditor::visibilityChanged()
+{
+    updateTimerRate();
+}
+
+void SSLCompressorAudioProcessorEditor::parentHierarchyChanged()
+{
+    updateTimerRate();
+}
+
+// Full rate while on screen. A hidden editor gets visibilityChanged() when it comes
+// back, a minimised window tells it nothing, so that case is polled slowly instead.
+void SSLCompressorAudioProcessorEditor::updateTimerRate()
+{
+    const int rate = isShowing() ? meterRateHz : (isVisible() ? hiddenPollRateHz : 0);
+
+    if (rate == 0)
+    {
+        stopTimer();
+    }
+    else if (getTimerInterval() != 1000 / rate)
+    {
+        // Nothing drained the fifo while the timer was stopped
+        if (! isTimerRunning())
+            processorRef.getMeterFifo().discard();
+
+        startTimerHz(rate);
+    }
+}
+
+//==============================================================================
+SSLEditorResources::SSLEditorResources()
+    : knobImage(juce::Image::ARGB, knobImageSize, knobImageSize, true),
+      labelFont(juce::FontOptions(12.0f)),
+      smallFont(juce::FontOptions(10.0f))
+{
+    juce::Graphics g(knobImage);
+    const auto bounds = knobImage.getBounds().toFloat().reduced(2.0f);
+    const auto centre = bounds.getCentre();
+
+    // Dark skirt, lit from the top left
+    g.setGradientFill(juce::ColourGradient(juce::Colour(0xff4a4a4a), bounds.getTopLeft(), juce::Colour(0xff141414), bounds.getBottomRight(), false));
+    g.fillEllipse(bounds);
+
+    // Raised cap
+    const auto cap = bounds.reduced(bounds.getWidth() * 0.16f);
+    g.setGradientFill(juce::ColourGradient(juce::Colour(0xff9a9a9a), cap.getTopLeft(), juce::Colour(0xff3a3a3a), cap.getBottomRight(), false));
+    g.fillEllipse(cap);
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.drawEllipse(cap, 1.5f);
+
+    // Pointer from the cap's edge towards the centre
+    const float pointerWidth = bounds.getWidth() * 0.05f;
+    g.setColour(juce::Colours::white);
+    g.fillRoundedRectangle(juce::Rectangle<float>(pointerWidth, bounds.getHeight() * 0.3f)
+                               .withCentre({ centre.x, bounds.getY() + bounds.getHeight() * 0.2f }), pointerWidth * 0.5f);
+}
+
+const juce::Image& SSLEditorResources::getKnobFrame (int pixelSize, float angle)
+{
+    auto& frames = knobFrames[pixelSize];
+
+    if (frames.empty())
+        frames.resize(numKnobFrames);
+
+    const int turns = juce::roundToInt(angle / juce::MathConstants<float>::twoPi * (float) numKnobFrames);
+    const int index = (turns % numKnobFrames + numKnobFrames) % numKnobFrames;
+    auto& frame = frames[(size_t) index];
+
+    if (frame.isNull())
+    {
+        frame = juce::Image(juce::Image::ARGB, pixelSize, pixelSize, true);
+        juce::Graphics g(frame);
+        const float half = 0.5f * (float) knobImageSize;
+
+        g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+        g.drawImageTransformed(knobImage, juce::AffineTransform::translation(-half, -half)
+                                              .scaled((float) pixelSize / (float) knobImageSize)
+                                              .rotated((float) index * juce::MathConstants<float>::twoPi / (float) numKnobFrames)
+                                              .translated(0.5f * (float) pixelSize, 0.5f * (float) pixelSize));
+    }
+
+    return frame;
+}
+
+//==============================================================================
+void SSLLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+                                      float sliderPos, float rotaryStartAngle, float rotaryEndAngle,
+                                      juce::Slider& slider)
+{
+    const auto bounds = juce::Rectangle<int>(x, y, width, height).toFloat();
+    const float diameter = juce::jmin(bounds.getWidth(), bounds.getHeight());
+    const auto centre = bounds.getCentre();
+    const float angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
+
+    // Value arc around the knob
+    const float arcRadius = diameter * 0.5f - 2.0f;
+    juce::Path track, value;
+    track.addCentredArc(centre.x, centre.y, arcRadius, arcRadius, 0.0f, rotaryStartAngle, rotaryEndAngle, true);
+    value.addCentredArc(centre.x, centre.y, arcRadius, arcRadius, 0.0f, rotaryStartAngle, angle, true);
+
+    const juce::PathStrokeType stroke(2.0f, juce::PathStrokeType::curved, juce::PathStrokeType::rounded);
+    g.setColour(slider.findColour(juce::Slider::rotarySliderOutlineColourId));
+    g.strokePath(track, stroke);
+    g.setColour(slider.findColour(juce::Slider::rotarySliderFillColourId));
+    g.strokePath(value, stroke);
+
+    // Knob body inside the arc: the cached frame for this angle at the display's pixel
+    // size, so it is blitted 1:1 instead of resampled on every repaint
+    const float knobDiameter = diameter - 10.0f;
+    const int pixelSize = juce::jmax(1, juce::roundToInt(knobDiameter * g.getInternalContext().getPhysicalPixelScaleFactor()));
+    g.drawImage(resources->getKnobFrame(pixelSize, angle), juce::Rectangle<float>(knobDiameter, knobDiameter).withCentre(centre));
+}
+
+//==============================================================================
+SSLVUMeter::SSLVUMeter()
+{
+    setOpaque(true);
+}
+
+void SSLVUMeter::setLevelDb (float newLevelDb)
+{
+    levelDb = newLevelDb;
+    const int newBarHeight = getBarHeight();
+
+    if (newBarHeight == barHeight)
+        return;
+
+    repaint(2, 2 + juce::jmin(barHeight, newBarHeight), getWidth() - 4, std::abs(newBarHeight - barHeight));
+    barHeight = newBarHeight;
+}
+
+void SSLVUMeter::paint (juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    g.setColour(juce::Colours::orange);
+    g.fillRect(getLocalBounds().reduced(2).removeFromTop(barHeight));
+}
+
+void SSLVUMeter::resized()
+{
+    barHeight = getBarHeight();
+}
+
+// Reduction grows down from the top, full scale is rangeDb
+int SSLVUMeter::getBarHeight() const noexcept
+{
+    const float proportion = juce::jlimit(0.0f, 1.0f, -levelDb / rangeDb);
+    return juce::roundToInt(proportion * (float) juce::jmax(0, getHeight() - 4));
+}
+
+//==============================================================================
+SSLGainReductionGraph::SSLGainReductionGraph (const SSLMeterHistory& h)
+    : history (h)
+{
+    setOpaque(true);
+}
+
+void SSLGainReductionGraph::update()
+{
+    const auto rows = getTraceRows();
+    const int numFrames = history.getNumFrames();
+
+    if (rows.isEmpty() && rows == paintedRows && numFrames == paintedNumFrames)
+        return;
+
+    // Half the stroke width plus antialiasing either side
+    const auto dirty = rows.getUnionWith(paintedRows);
+    const int top = (int) std::floor(dirty.getStart()) - 2;
+    repaint(0, top, getWidth(), (int) std::ceil(dirty.getEnd()) + 2 - top);
+
+    paintedRows = rows;
+    paintedNumFrames = numFrames;
+}
+
+void SSLGainReductionGraph::resized()
+{
+    paintedRows = getTraceRows();
+    paintedNumFrames = history.getNumFrames();
+}
+
+float SSLGainReductionGraph::getTraceY (float gainReductionDb) const noexcept
+{
+    const float height = (float) getHeight();
+    return juce::jmin(height, -gainReductionDb * height / SSLVUMeter::rangeDb);
+}
+
+// Vertical extent of the trace; empty while fewer than two frames draw nothing
+juce::Range<float> SSLGainReductionGraph::getTraceRows() const noexcept
+{
+    const int numFrames = history.getNumFrames();
+
+    if (numFrames < 2)
+        return {};
+
+    auto rows = juce::Range<float>::emptyRange(getTraceY(history.getFrame(0).gainReductionPeakDb));
+
+    for (int age = 1; age < numFrames; ++age)
+        rows = rows.getUnionWith(getTraceY(history.getFrame(age).gainReductionPeakDb));
+
+    return rows;
+}
+
+void SSLGainReductionGraph::paint (juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    g.fillAll(juce::Colours::black);
+
+    const int numFrames = history.getNumFrames();
+
+    if (numFrames < 2)
+        return;
+
+    // One frame per step across the full history, so the graph scrolls at a constant speed
+    const float step = bounds.getWidth() / (float) (SSLMeterHistory::size - 1);
+
+    juce::Path path;
+
+    for (int age = 0; age < numFrames; ++age)
+    {
+        const float x = bounds.getRight() - (float) age * step;
+        const float y = getTraceY(history.getFrame(age).gainReductionPeakDb);
+
+        if (age == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(path, juce::PathStrokeType(1.5f));
 }
\ No newline at end of file
@@ -3,21 +3,90 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 
+//==============================================================================
+// Editor resources. Every editor in the process holds them through a
+// juce::SharedResourcePointer: the first one to open renders them, later ones
+// attach to the same copy, and the last one to close frees them.
+class SSLEditorResources
+{
+public:
+    SSLEditorResources();
+
+    // Knob body with its pointer straight up, rendered at twice the largest knob size
+    static constexpr int knobImageSize = 160;
+    juce::Image knobImage;
+
+    juce::Font labelFont, smallFont;
+
+    // The knob turned to angle (radians, 0 = pointer up), pixelSize square in device
+    // pixels. Frames are cached per size and per 1/numKnobFrames of a turn, each one
+    // rendered the first time it is asked for. Message thread only.
+    static constexpr int numKnobFrames = 128;
+    const juce::Image& getKnobFrame (int pixelSize, float angle);
+
+private:
+    std::map<int, std::vector<juce::Image>> knobFrames;
+};
+
 //==============================================================================
 // Custom knob style LookAndFeel class
 class SSLLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    SSLLookAndFeel();
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                          float sliderPos, float rotaryStartAngle, float rotaryEndAngle,
                          juce::Slider& slider) override;
 private:
-    juce::Image knobImage;
+    juce::SharedResourcePointer<SSLEditorResources> resources;
 };
 
 //==============================================================================
-class SSLCompressorAudioProcessorEditor : public juce::AudioProcessorEditor
+// Gain reduction meter: a vertical bar growing down from 0 dB
+class SSLVUMeter : public juce::Component
+{
+public:
+    static constexpr float rangeDb = 20.0f;
+
+    SSLVUMeter();
+
+    // Repaints only the rows between the old and the new end of the bar, nothing if it did not move
+    void setLevelDb (float newLevelDb);
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    int getBarHeight() const noexcept;
+
+    float levelDb = 0.0f;
+    int barHeight = 0;  // as last painted, in pixels
+};
+
+//==============================================================================
+// Scrolling gain reduction graph over the meter history, newest frame on the right
+class SSLGainReductionGraph : public juce::Component
+{
+public:
+    explicit SSLGainReductionGraph (const SSLMeterHistory& history);
+
+    // Called after new frames arrived. The trace scrolls across the full width, so the
+    // dirty region is the band of rows it covered before and covers now; a flat trace
+    // that has not moved or grown is left alone.
+    void update();
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    float getTraceY (float gainReductionDb) const noexcept;
+    juce::Range<float> getTraceRows() const noexcept;
+
+    const SSLMeterHistory& history;
+    juce::Range<float> paintedRows;
+    int paintedNumFrames = 0;
+};
+
+//==============================================================================
+class SSLCompressorAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                          private juce::Timer
 {
 public:
     SSLCompressorAudioProcessorEditor (SSLCompressorAudioProcessor&);
@@ -28,15 +97,28 @@ public:
     void resized() override;
 
 private:
-    SSLCompressorAudioProcessor& audioProcessor;
-    SSLLookAndFeel sslLookAndFeel;
+    void timerCallback() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+    void updateTimerRate();
+    void setupSlider (juce::Slider& slider, juce::Label& label, const juce::String& text, const juce::StringRef paramID,
+                      std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>& attachment, bool isStepped = false);
+
+    static constexpr int meterRateHz = 30;
+    static constexpr int hiddenPollRateHz = 2;
+
+    SSLCompressorAudioProcessor& processorRef;
+
+    // Declared before the components so it outlives the sliders that use it
+    juce::SharedResourcePointer<SSLEditorResources> resources;
+    SSLLookAndFeel lookAndFeel;
 
     // Knobs
-    juce::Slider thresholdKnob;
-    juce::Slider ratioKnob;
-    juce::Slider attackKnob;
-    juce::Slider releaseKnob;
-    juce::Slider makeupKnob;
+    juce::Slider thresholdSlider;
+    juce::Slider ratioSlider;
+    juce::Slider attackSlider;
+    juce::Slider releaseSlider;
+    juce::Slider makeupSlider;
 
     // Labels
     juce::Label thresholdLabel;
@@ -44,7 +126,6 @@ private:
     juce::Label attackLabel;
     juce::Label releaseLabel;
     juce::Label makeupLabel;
-    juce::Label titleLabel;
 
     // Attachments for parameter control
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> thresholdAttachment;
@@ -53,8 +134,24 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> makeupAttachment;
 
-    // Gain reduction meter
-    float gainReduction;
+    // Bypass ("IN") button
+    juce::TextButton bypassButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassAttachment;
+
+    // Factory presets and A/B compare along the top
+    juce::ComboBox presetBox;
+    juce::TextButton compareAButton { "A" }, compareBButton { "B" }, compareCopyButton { "Copy" };
+
+   #if SSL_INSTRUMENTATION
+    // Block timing and real-time safety counts, instrumented builds only
+    juce::Label blockStatsLabel;
+   #endif
+
+    // Metering: frames drained from the processor on the timer, shown by the VU meter and the GR graph
+    SSLMeterHistory meterHistory;
+    bool metersOutOfDate = false;   // frames drained while hidden, not shown yet
+    SSLVUMeter vuMeter;
+    SSLGainReductionGraph gainReductionGraph { meterHistory };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SSLCompressorAudioProcessorEditor)
 };
\ No newline at end of file
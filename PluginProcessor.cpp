@@ -1,6 +1,89 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    // Storage order of the saved state. Never reorder: new parameters go at the end,
+    // and states saved before them load with them at their defaults. Setup parameters
+    // describe the session rather than the sound, so presets and A/B leave them alone.
+    struct StateParameter
+    {
+        const char* id;
+        bool isSetup;
+    };
+
+    constexpr StateParameter stateParameterTable[] =
+    {
+        { SSLCompressorAudioProcessor::PARAM_THRESHOLD, false },
+        { SSLCompressorAudioProcessor::PARAM_RATIO, false },
+        { SSLCompressorAudioProcessor::PARAM_ATTACK, false },
+        { SSLCompressorAudioProcessor::PARAM_RELEASE, false },
+        { SSLCompressorAudioProcessor::PARAM_MAKEUP, false },
+        { SSLCompressorAudioProcessor::PARAM_PRECISION, true },
+        { SSLCompressorAudioProcessor::PARAM_LOOKAHEAD, false },
+        { SSLCompressorAudioProcessor::PARAM_OVERSAMPLING, true },
+        { SSLCompressorAudioProcessor::PARAM_RENDER_OVERSAMPLING, true },
+        { SSLCompressorAudioProcessor::PARAM_OVERSAMPLING_FILTER, true },
+        { SSLCompressorAudioProcessor::PARAM_DETECTION, false },
+        { SSLCompressorAudioProcessor::PARAM_TOPOLOGY, false },
+        { SSLCompressorAudioProcessor::PARAM_KNEE, false },
+        { SSLCompressorAudioProcessor::PARAM_STEREO_LINK, false },
+        { SSLCompressorAudioProcessor::PARAM_LINK_AMOUNT, false },
+        { SSLCompressorAudioProcessor::PARAM_LINK_GROUPS, true },
+        { SSLCompressorAudioProcessor::PARAM_BYPASS, true },
+        { SSLCompressorAudioProcessor::PARAM_BANDS, false },
+        { SSLCompressorAudioProcessor::PARAM_CROSSOVER_LOW, false },
+        { SSLCompressorAudioProcessor::PARAM_CROSSOVER_MID, false },
+        { SSLCompressorAudioProcessor::PARAM_CROSSOVER_HIGH, false },
+        { SSLCompressorAudioProcessor::PARAM_DRIVE, false },
+    };
+
+    constexpr bool isSameID (const char* a, const char* b) noexcept
+    {
+        while (*a != 0 && *a == *b)
+        {
+            ++a;
+            ++b;
+        }
+
+        return *a == *b;
+    }
+
+    constexpr int getStateIndex (const char* parameterID) noexcept
+    {
+        for (int i = 0; i < (int) std::size (stateParameterTable); ++i)
+            if (isSameID (stateParameterTable[i].id, parameterID))
+                return i;
+
+        return -1;
+    }
+
+    // Positions of the values the audio thread reads from its applied set, resolved at compile time
+    using Processor = SSLCompressorAudioProcessor;
+    constexpr int thresholdIndex = getStateIndex (Processor::PARAM_THRESHOLD);
+    constexpr int ratioIndex = getStateIndex (Processor::PARAM_RATIO);
+    constexpr int attackIndex = getStateIndex (Processor::PARAM_ATTACK);
+    constexpr int releaseIndex = getStateIndex (Processor::PARAM_RELEASE);
+    constexpr int makeupIndex = getStateIndex (Processor::PARAM_MAKEUP);
+    constexpr int precisionIndex = getStateIndex (Processor::PARAM_PRECISION);
+    constexpr int lookaheadIndex = getStateIndex (Processor::PARAM_LOOKAHEAD);
+    constexpr int oversamplingIndex = getStateIndex (Processor::PARAM_OVERSAMPLING);
+    constexpr int renderOversamplingIndex = getStateIndex (Processor::PARAM_RENDER_OVERSAMPLING);
+    constexpr int oversamplingFilterIndex = getStateIndex (Processor::PARAM_OVERSAMPLING_FILTER);
+    constexpr int detectionIndex = getStateIndex (Processor::PARAM_DETECTION);
+    constexpr int topologyIndex = getStateIndex (Processor::PARAM_TOPOLOGY);
+    constexpr int kneeIndex = getStateIndex (Processor::PARAM_KNEE);
+    constexpr int stereoLinkIndex = getStateIndex (Processor::PARAM_STEREO_LINK);
+    constexpr int linkAmountIndex = getStateIndex (Processor::PARAM_LINK_AMOUNT);
+    constexpr int linkGroupsIndex = getStateIndex (Processor::PARAM_LINK_GROUPS);
+    constexpr int bypassIndex = getStateIndex (Processor::PARAM_BYPASS);
+    constexpr int bandsIndex = getStateIndex (Processor::PARAM_BANDS);
+    constexpr int crossoverLowIndex = getStateIndex (Processor::PARAM_CROSSOVER_LOW);
+    constexpr int crossoverMidIndex = getStateIndex (Processor::PARAM_CROSSOVER_MID);
+    constexpr int crossoverHighIndex = getStateIndex (Processor::PARAM_CROSSOVER_HIGH);
+    constexpr int driveIndex = getStateIndex (Processor::PARAM_DRIVE);
+}
+
 //==============================================================================
 SSLCompressorAudioProcessor::SSLCompressorAudioProcessor()
     : AudioProcessor(BusesProperties()
@@ -8,75 +91,203 @@ SSLCompressorAudioProcessor::SSLCompressorAudioProcessor()
                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       parameters(*this, nullptr, "Parameters", createParameterLayout())
 {
-    // Initialize compressor parameters
-    addParameter(threshold = new juce::AudioParameterFloat("threshold", 
-                                                         "Threshold", 
-                                                         -60.0f, 
-                                                         0.0f, 
-                                                         -20.0f));
-                                                         
-    addParameter(ratio = new juce::AudioParameterFloat("ratio",
-                                                     "Ratio",
-                                                     1.0f,
-                                                     10.0f,
-                                                     4.0f));
-                                                     
-    addParameter(attack = new juce::AudioParameterFloat("attack",
-                                                      "Attack",
-                                                      0.1f,
-                                                      100.0f,
-                                                      10.0f));
-                                                      
-    addParameter(release = new juce::AudioParameterFloat("release",
-                                                       "Release",
-                                                       10.0f,
-                                                       1000.0f,
-                                                       100.0f));
-                                                       
-    addParameter(makeupGain = new juce::AudioParameterFloat("makeup",
-                                                          "Makeup Gain",
-                                                          0.0f,
-                                                          20.0f,
-                                                          0.0f));
-                                                          
+    // The value tree state owns the parameters, keep typed pointers for the audio thread
+    threshold = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_THRESHOLD));
+    ratio = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_RATIO));
+    attack = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_ATTACK));
+    release = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_RELEASE));
+    makeupGain = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_MAKEUP));
+    precision = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_PRECISION));
+    lookahead = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_LOOKAHEAD));
+    oversampling = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_OVERSAMPLING));
+    renderOversampling = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_RENDER_OVERSAMPLING));
+    oversamplingFilter = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_OVERSAMPLING_FILTER));
+    detection = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_DETECTION));
+    topology = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_TOPOLOGY));
+    knee = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_KNEE));
+    stereoLink = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_STEREO_LINK));
+    linkAmount = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_LINK_AMOUNT));
+    linkGroups = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_LINK_GROUPS));
+    bypass = dynamic_cast<juce::AudioParameterBool*> (parameters.getParameter (PARAM_BYPASS));
+    bands = dynamic_cast<juce::AudioParameterChoice*> (parameters.getParameter (PARAM_BANDS));
+    crossoverLow = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_CROSSOVER_LOW));
+    crossoverMid = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_CROSSOVER_MID));
+    crossoverHigh = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_CROSSOVER_HIGH));
+    drive = dynamic_cast<juce::AudioParameterFloat*> (parameters.getParameter (PARAM_DRIVE));
+
+    static_assert (juce::numElementsInArray (stateParameterTable) == numStateParameters,
+                   "every parameter needs a place in the saved state");
+
+    for (int i = 0; i < numStateParameters; ++i)
+    {
+        stateParameters[i] = parameters.getParameter (stateParameterTable[i].id);
+        rawStateValues[i] = parameters.getRawParameterValue (stateParameterTable[i].id);
+        stateDirtyFlags[i] = getDirtyFlag (stateParameterTable[i].id);
+        defaultSnapshot.values[i] = stateParameters[i]->convertFrom0to1 (stateParameters[i]->getDefaultValue());
+    }
+
+    // The factory bank is built once here, so recalling a preset only copies values
+    for (int index = 0; index < SSLFactoryPresets::numPresets; ++index)
+    {
+        const auto& preset = SSLFactoryPresets::bank[index];
+        auto& snapshot = factorySnapshots[index];
+        snapshot = defaultSnapshot;
+
+        snapshot.values[getStateIndex (PARAM_THRESHOLD)] = preset.threshold;
+        snapshot.values[getStateIndex (PARAM_RATIO)] = preset.ratio;
+        snapshot.values[getStateIndex (PARAM_ATTACK)] = preset.attack;
+        snapshot.values[getStateIndex (PARAM_RELEASE)] = preset.release;
+        snapshot.values[getStateIndex (PARAM_MAKEUP)] = preset.makeup;
+        snapshot.values[getStateIndex (PARAM_KNEE)] = preset.knee;
+        snapshot.values[getStateIndex (PARAM_DETECTION)] = (float) preset.detection;
+        snapshot.values[getStateIndex (PARAM_TOPOLOGY)] = (float) preset.topology;
+        snapshot.values[getStateIndex (PARAM_BANDS)] = (float) preset.bands;
+        snapshot.values[getStateIndex (PARAM_DRIVE)] = preset.drive;
+    }
+
+    compareSnapshot = defaultSnapshot;
+
     currentGainReduction = 0.0f;
-    envelopeDetector = 0.0f;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SSLCompressorAudioProcessor::createParameterLayout()
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("threshold", 
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_THRESHOLD,
                                                                "Threshold",
                                                                -60.0f,
                                                                0.0f,
                                                                -20.0f));
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("ratio",
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_RATIO,
                                                                "Ratio",
                                                                1.0f,
                                                                10.0f,
                                                                4.0f));
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("attack",
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_ATTACK,
                                                                "Attack",
                                                                0.1f,
                                                                100.0f,
                                                                10.0f));
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("release",
+    // The last stretch of the knob past maxReleaseMs snaps to Auto
+    juce::NormalisableRange<float> releaseRange (10.0f, autoReleaseMs,
+                                                 [] (float start, float end, float proportion) { return start + proportion * (end - start); },
+                                                 [] (float start, float end, float value) { return (value - start) / (end - start); },
+                                                 [] (float, float end, float value) { return value > maxReleaseMs ? end : value; });
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_RELEASE,
                                                                "Release",
-                                                               10.0f,
-                                                               1000.0f,
-                                                               100.0f));
+                                                               releaseRange,
+                                                               100.0f,
+                                                               juce::AudioParameterFloatAttributes()
+                                                                   .withStringFromValueFunction ([] (float value, int)
+                                                                   {
+                                                                       return value > maxReleaseMs ? juce::String ("Auto") : juce::String (value, 0);
+                                                                   })
+                                                                   .withValueFromStringFunction ([] (const juce::String& text)
+                                                                   {
+                                                                       return text.trim().equalsIgnoreCase ("Auto") ? autoReleaseMs : text.getFloatValue();
+                                                                   })));
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("makeup",
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_MAKEUP,
                                                                "Makeup",
                                                                0.0f,
                                                                20.0f,
                                                                0.0f));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_PRECISION,
+                                                                "Precision",
+                                                                juce::StringArray { "Exact", "High", "Fast" },
+                                                                1));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_LOOKAHEAD,
+                                                               "Lookahead",
+                                                               0.0f,
+                                                               maxLookaheadMs,
+                                                               0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_OVERSAMPLING,
+                                                                "Oversampling",
+                                                                juce::StringArray { "Off", "2x", "4x", "8x" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_RENDER_OVERSAMPLING,
+                                                                "Render Oversampling",
+                                                                juce::StringArray { "Off", "2x", "4x", "8x" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_OVERSAMPLING_FILTER,
+                                                                "Oversampling Filter",
+                                                                juce::StringArray { "Low Latency", "Linear Phase" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_DETECTION,
+                                                                "Detection",
+                                                                juce::StringArray { "Peak", "RMS" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_TOPOLOGY,
+                                                                "Topology",
+                                                                juce::StringArray { "Feed-Forward", "Feedback" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_KNEE,
+                                                               "Knee",
+                                                               0.0f,
+                                                               12.0f,
+                                                               0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_STEREO_LINK,
+                                                                "Stereo Link",
+                                                                juce::StringArray { "Max", "Average" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_LINK_AMOUNT,
+                                                               "Link Amount",
+                                                               0.0f,
+                                                               100.0f,
+                                                               100.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_LINK_GROUPS,
+                                                                "Link Groups",
+                                                                juce::StringArray { "All", "LFE Independent", "Fronts / Surrounds / Heights", "Independent" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(PARAM_BYPASS,
+                                                              "Bypass",
+                                                              false));
+
+    // Off runs the full-band kernel; otherwise the crossovers are used from the lowest up
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(PARAM_BANDS,
+                                                                "Bands",
+                                                                juce::StringArray { "Off", "2 Bands", "3 Bands", "4 Bands" },
+                                                                0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_CROSSOVER_LOW,
+                                                               "Crossover Low",
+                                                               juce::NormalisableRange<float> (20.0f, 1000.0f, 0.0f, 0.4f),
+                                                               200.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_CROSSOVER_MID,
+                                                               "Crossover Mid",
+                                                               juce::NormalisableRange<float> (200.0f, 5000.0f, 0.0f, 0.4f),
+                                                               1500.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_CROSSOVER_HIGH,
+                                                               "Crossover High",
+                                                               juce::NormalisableRange<float> (1000.0f, 16000.0f, 0.0f, 0.4f),
+                                                               6000.0f));
+
+    // Saturation after the gain stage, in percent of the strongest curve; 0 takes it out
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(PARAM_DRIVE,
+                                                               "Drive",
+                                                               0.0f,
+                                                               100.0f,
+                                                               0.0f));
+
     return { params.begin(), params.end() };
 }
 
@@ -90,66 +301,1150 @@ void SSLCompressorAudioProcessor::prepareToPlay (double sampleRate, int samplesP
     // Initialize processing variables
     this->sampleRate = sampleRate;
     currentGainReduction = 0.0f;
-    envelopeDetector = 0.0f;
+    floatState.kernelState.reset();
+    doubleState.kernelState.reset();
+    for (auto& path : floatState.bandPaths)
+        path.state.reset();
+
+    for (auto& path : doubleState.bandPaths)
+        path.state.reset();
+
+    floatState.saturatorState.reset();
+    doubleState.saturatorState.reset();
+
+    // Start from the parameters as they are; holding the recall lock keeps a recall from tearing them
+    {
+        const juce::SpinLock::ScopedLockType lock (recallLock);
+        takeParameterValues();
+    }
+
+    numBands = (int) getApplied (bandsIndex) + 1;
+
+    // Pick the dB conversion kernels and the detector specialisation once, not per sample
+    precisionDirty = false;
+    selectMathKernels ((int) getApplied (precisionIndex));
+    kernelDirty = false;
+    selectKernel();
+
+    maxBlockSize = juce::jmax (1, samplesPerBlock);
+    const int numChannels = juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels());
+
+    // Remember which speaker each channel feeds so the link groups can be rebuilt without touching the bus
+    const auto channelSet = getChannelLayoutOfBus (false, 0);
+    numLinkChannels = juce::jmin (numChannels, SSLLinkLayout::maxChannels);
+
+    for (int channel = 0; channel < numLinkChannels; ++channel)
+        channelTypes[channel] = channelSet.getTypeOfChannel (channel);
+
+    linkDirty = false;
+    updateLinkLayout();
+
+    // Only the precision the host processes in gets buffers
+    if (isUsingDoublePrecision())
+    {
+        prepareState (doubleState, numChannels);
+        releaseState (floatState);
+    }
+    else
+    {
+        prepareState (floatState, numChannels);
+        releaseState (doubleState);
+    }
+
+    // The oversamplers were just rebuilt, so the whole setup is too
+    processingRate = 0.0;
+    setupDirty = false;
+    updateProcessingSetup();
+
+    // Start without a ramp from whatever the smoothers held before
+    thresholdSmoother.setCurrentAndTargetValue (getApplied (thresholdIndex));
+    slopeSmoother.setCurrentAndTargetValue (SSLGainComputer::getSlope (getApplied (ratioIndex)));
+    makeupSmoother.setCurrentAndTargetValue (getApplied (makeupIndex));
+    driveSmoother.setCurrentAndTargetValue (SSLSaturator::getCurveGain (getApplied (driveIndex)));
+
+    bypassTarget = getApplied (bypassIndex) > 0.5f;
+    bypassPrimeSamples = 0;
+    bypassMix.reset (sampleRate, bypassFadeSeconds);
+    bypassMix.setCurrentAndTargetValue (bypassTarget ? 1.0f : 0.0f);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::prepareState (ProcessingState<SampleType>& state, int numChannels)
+{
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+
+    // Build every oversampler up front so switching factor, filter or live/render never allocates.
+    // Integer latency keeps the reported latency exact for the IIR filters too.
+    for (int filter = 0; filter < numOversamplingFilters; ++filter)
+    {
+        for (int stages = 1; stages <= maxOversamplingStages; ++stages)
+        {
+            auto& oversampler = state.oversamplers[filter][stages - 1];
+            oversampler = std::make_unique<Oversampling> ((size_t) numChannels,
+                                                          (size_t) stages,
+                                                          filter == 0 ? Oversampling::filterHalfBandPolyphaseIIR
+                                                                      : Oversampling::filterHalfBandFIREquiripple,
+                                                          true,
+                                                          true);
+            oversampler->initProcessing ((size_t) maxBlockSize);
+        }
+    }
+
+    // Scratch space for the block-based gain computer at the highest rate:
+    // a temp lane, the threshold, slope, makeup and drive ramps, and one detector/gain lane per channel
+    state.scratchBuffer.setSize (numRampLanes + numLinkChannels, maxBlockSize << maxOversamplingStages);
+
+    for (int channel = 0; channel < numLinkChannels; ++channel)
+        state.detectorLanes[channel] = state.scratchBuffer.getWritePointer (numRampLanes + channel);
+
+    state.quietSamples = 0;
+
+    // Size the lookahead for the longest setting at the highest rate so changing it never allocates
+    const int maxLookaheadSamples = (int) std::ceil (maxLookaheadMs * 0.001 * sampleRate);
+    state.lookaheadDelay.prepare (numChannels, maxLookaheadSamples << maxOversamplingStages);
+
+    // The bypass delay covers the longest lookahead plus the slowest oversampler, at the host rate
+    float maxOversamplingLatency = 0.0f;
+
+    for (auto& filterOversamplers : state.oversamplers)
+        for (auto& oversampler : filterOversamplers)
+            maxOversamplingLatency = juce::jmax (maxOversamplingLatency, (float) oversampler->getLatencyInSamples());
+
+    state.bypassDelay.prepare (numChannels, maxLookaheadSamples + (int) std::ceil (maxOversamplingLatency));
+    state.dryBuffer.setSize (numChannels, maxBlockSize);
+
+    // Multiband storage for the most bands at the highest rate, so changing the band count never allocates
+    constexpr int maxBands = SSLCrossover<SampleType>::maxBands;
+    state.bandBuffer.setSize (maxBands * numChannels, maxBlockSize << maxOversamplingStages);
+    state.bandLevelBuffer.setSize (numLinkChannels, (maxBlockSize << maxOversamplingStages) * maxBands);
+
+    for (int channel = 0; channel < numLinkChannels; ++channel)
+        state.bandLevels[channel] = state.bandLevelBuffer.getWritePointer (channel);
+
+    for (auto& path : state.bandPaths)
+    {
+        path.crossover.prepare (numChannels);
+        path.lookahead.prepare (maxBands * numChannels, maxLookaheadSamples << maxOversamplingStages);
+    }
+
+    state.fadeBuffer.setSize (numChannels, maxBlockSize << maxOversamplingStages);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::releaseState (ProcessingState<SampleType>& state)
+{
+    state.activeOversampler = nullptr;
+
+    for (auto& filterOversamplers : state.oversamplers)
+        for (auto& oversampler : filterOversamplers)
+            oversampler.reset();
+
+    state.scratchBuffer.setSize (0, 0);
+    state.lookaheadDelay.release();
+    state.bypassDelay.release();
+    state.dryBuffer.setSize (0, 0);
+    state.bandBuffer.setSize (0, 0);
+    state.bandLevelBuffer.setSize (0, 0);
+    state.fadeBuffer.setSize (0, 0);
+
+    for (auto& path : state.bandPaths)
+    {
+        path.crossover.release();
+        path.lookahead.release();
+    }
+}
+
+void SSLCompressorAudioProcessor::releaseResources()
+{
+    maxBlockSize = 0;
+    releaseState (floatState);
+    releaseState (doubleState);
+}
+
+bool SSLCompressorAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+    // Any layout up to 7.1.4, as long as input and output match
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+
+    if (mainOutput.isDisabled() || mainOutput.size() > SSLLinkLayout::maxChannels)
+        return false;
+
+    return mainOutput == layouts.getMainInputChannelSet();
+}
+
+void SSLCompressorAudioProcessor::setNonRealtime (bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime (isNonRealtime);
+
+    // Switching between live and render may change the oversampling factor
+    setupDirty = true;
+}
+
+// The derived state a parameter feeds. Threshold, ratio, makeup, drive and bypass are
+// read every block and need none.
+std::atomic<bool>* SSLCompressorAudioProcessor::getDirtyFlag (const juce::String& parameterID) noexcept
+{
+    if (parameterID == PARAM_ATTACK || parameterID == PARAM_RELEASE)
+        return &coefficientsDirty;
+    else if (parameterID == PARAM_PRECISION)
+        return &precisionDirty;
+    else if (parameterID == PARAM_DETECTION || parameterID == PARAM_TOPOLOGY
+              || parameterID == PARAM_KNEE || parameterID == PARAM_STEREO_LINK)
+        return &kernelDirty;
+    else if (parameterID == PARAM_LINK_AMOUNT || parameterID == PARAM_LINK_GROUPS)
+        return &linkDirty;
+    else if (parameterID == PARAM_BANDS || parameterID == PARAM_CROSSOVER_LOW
+              || parameterID == PARAM_CROSSOVER_MID || parameterID == PARAM_CROSSOVER_HIGH)
+        return &bandsDirty;
+    else if (parameterID == PARAM_LOOKAHEAD)
+        return &lookaheadDirty;
+    else if (parameterID == PARAM_OVERSAMPLING || parameterID == PARAM_RENDER_OVERSAMPLING
+              || parameterID == PARAM_OVERSAMPLING_FILTER)
+        return &setupDirty;
+
+    return nullptr;
+}
+
+// Reads every parameter as one set: the raw values, or the recall slot while a recall is
+// writing them. The serial is checked again afterwards; if a recall started or ended in
+// between, the set may be torn and is dropped, and the block keeps the previous one.
+bool SSLCompressorAudioProcessor::takeParameterValues()
+{
+    const auto serial = recallSerial.load (std::memory_order_acquire);
+    const bool recalling = (serial & 1) != 0;
+    StateSnapshot values;
+
+    for (int i = 0; i < numStateParameters; ++i)
+        values.values[i] = (recalling ? recallValues[i] : *rawStateValues[i]).load (std::memory_order_relaxed);
+
+    std::atomic_thread_fence (std::memory_order_acquire);
+
+    if (recallSerial.load (std::memory_order_relaxed) != serial)
+        return false;
+
+    // Only what changed since the last set gets its derived state rebuilt
+    for (int i = 0; i < numStateParameters; ++i)
+        if (values.values[i] != appliedValues.values[i] && stateDirtyFlags[i] != nullptr)
+            stateDirtyFlags[i]->store (true);
+
+    appliedValues = values;
+    return true;
 }
 
 void SSLCompressorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, floatState, false);
+}
+
+void SSLCompressorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, doubleState, false);
+}
+
+// Hosts that bypass without going through the bypass parameter get the same
+// crossfade and the same latency as when the parameter is set.
+void SSLCompressorAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, floatState, true);
+}
+
+void SSLCompressorAudioProcessor::processBlockBypassed (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, doubleState, true);
+}
+
+juce::AudioProcessorParameter* SSLCompressorAudioProcessor::getBypassParameter() const
+{
+    return bypass;
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer, ProcessingState<SampleType>& state, bool hostBypassed)
 {
     juce::ScopedNoDenormals noDenormals;
     
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
-    
-    // Calculate time constants
-    const float attackTime = *attack / 1000.0f;  // Convert to seconds
-    const float releaseTime = *release / 1000.0f;
-    
-    const float attackCoeff = std::exp(-1.0f / (sampleRate * attackTime));
-    const float releaseCoeff = std::exp(-1.0f / (sampleRate * releaseTime));
-    
-    // Process each sample
-    for (int sample = 0; sample < numSamples; ++sample)
+
+    if (numChannels == 0 || maxBlockSize == 0 || state.scratchBuffer.getNumChannels() == 0)
+        return;
+
+   #if SSL_INSTRUMENTATION
+    const SSLBlockProbe::Scope probeScope (blockProbe, numSamples, sampleRate);
+   #endif
+
+    // Every parameter this block uses comes from one set, so a recall applies all at once
+    if (takeParameterValues())
+        applyParameterChanges();
+
+    updateBypass (state, hostBypassed || getApplied (bypassIndex) > 0.5f);
+
+    juce::dsp::AudioBlock<SampleType> block (buffer);
+
+    // Hosts may send more samples than announced in prepareToPlay, so work in prepared-size chunks
+    for (int start = 0; start < numSamples; start += maxBlockSize)
     {
-        // Find maximum absolute value across all channels (for stereo linking)
-        float inputLevel = 0.0f;
-        for (int channel = 0; channel < numChannels; ++channel)
+        const int chunkSize = juce::jmin (maxBlockSize, numSamples - start);
+        auto chunk = block.getSubBlock ((size_t) start, (size_t) chunkSize);
+
+        if (isBypassSettled (false))
+            processWet (chunk, state);
+        else if (isBypassSettled (true))
+            processBypassed (chunk, state);
+        else
+            processTransition (chunk, state);
+    }
+}
+
+void SSLCompressorAudioProcessor::applyParameterChanges()
+{
+    // Derived state is only rebuilt when a listener flagged a change
+    if (precisionDirty.exchange (false))
+        selectMathKernels ((int) getApplied (precisionIndex));
+
+    if (kernelDirty.exchange (false))
+        selectKernel();
+
+    if (linkDirty.exchange (false))
+        updateLinkLayout();
+
+    if (setupDirty.exchange (false))
+        updateProcessingSetup();
+
+    if (lookaheadDirty.exchange (false))
+        updateLatency();
+
+    if (coefficientsDirty.exchange (false))
+        updateEnvelopeCoefficients();
+
+    // A band change waits for a running band crossfade to finish, unless nothing of it is heard
+    const bool bypassed = isBypassSettled (true);
+
+    if ((fadingNumBands == 0 || bypassed) && bandsDirty.exchange (false))
+        updateBands (! bypassed);
+
+    // New targets ramp in per sample instead of jumping at the block boundary
+    thresholdSmoother.setTargetValue (getApplied (thresholdIndex));
+    slopeSmoother.setTargetValue (SSLGainComputer::getSlope (getApplied (ratioIndex)));
+    makeupSmoother.setTargetValue (getApplied (makeupIndex));
+    driveSmoother.setTargetValue (SSLSaturator::getCurveGain (getApplied (driveIndex)));
+}
+
+bool SSLCompressorAudioProcessor::isBypassSettled (bool bypassed) const noexcept
+{
+    return bypassTarget == bypassed && bypassPrimeSamples == 0 && ! bypassMix.isSmoothing()
+            && bypassMix.getTargetValue() == (bypassed ? 1.0f : 0.0f);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::updateBypass (ProcessingState<SampleType>& state, bool shouldBypass)
+{
+    if (shouldBypass == bypassTarget)
+        return;
+
+    const bool wasSettled = isBypassSettled (bypassTarget);
+    bypassTarget = shouldBypass;
+
+    if (wasSettled)
+    {
+        // Whatever the oversampler and lookahead held from before the bypass is stale.
+        // The kernel state is kept: the bypassed detector has been keeping it current.
+        if (! shouldBypass)
         {
-            float* channelData = buffer.getWritePointer(channel);
-            inputLevel = std::max(inputLevel, std::abs(channelData[sample]));
+            if (state.activeOversampler != nullptr)
+                state.activeOversampler->reset();
+
+            state.lookaheadDelay.reset();
+            state.quietSamples = 0;
+
+            // The warm detector only follows the full band, so the bands restart from it.
+            // Nothing was heard of a band crossfade that was running, so it ends here.
+            fadingNumBands = 0;
+            bandPrimeSamples = 0;
+
+            if (numBands > 1)
+                switchBands (state, 1, false);
         }
-        
-        // Convert to dB
-        float inputLevelDB = 20.0f * std::log10(inputLevel + 1e-6f);
-        
-        // Calculate gain reduction amount
-        float gainReductionDB = 0.0f;
-        if (inputLevelDB > *threshold)
+
+        bypassPrimeSamples = getLatencySamples();
+    }
+    else
+    {
+        // Reversed mid-transition: both paths are still running, so fade straight back
+        bypassPrimeSamples = 0;
+    }
+
+    if (bypassPrimeSamples == 0)
+        bypassMix.setTargetValue (shouldBypass ? 1.0f : 0.0f);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::processWet (juce::dsp::AudioBlock<SampleType> block, ProcessingState<SampleType>& state)
+{
+    if (state.activeOversampler != nullptr)
+    {
+        compressBlock (state.activeOversampler->processSamplesUp (block), state);
+        state.activeOversampler->processSamplesDown (block);
+    }
+    else
+    {
+        compressBlock (block, state);
+    }
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::processTransition (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state)
+{
+    // Both paths run: the dry copy through the bypass delay, the block through the compressor
+    const int numSamples = (int) block.getNumSamples();
+    const int numChannels = (int) block.getNumChannels();
+    auto* const* dry = state.dryBuffer.getArrayOfWritePointers();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::copy (dry[channel], block.getChannelPointer ((size_t) channel), numSamples);
+
+    state.bypassDelay.process (juce::dsp::AudioBlock<SampleType> (dry, (size_t) numChannels, (size_t) numSamples));
+    processWet (block, state);
+
+    if (bypassPrimeSamples > 0)
+    {
+        // Hold the current mix until the incoming path is primed, then start the fade
+        if (bypassMix.getTargetValue() == 1.0f)
+            for (int channel = 0; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::copy (block.getChannelPointer ((size_t) channel), dry[channel], numSamples);
+
+        bypassPrimeSamples = juce::jmax (0, bypassPrimeSamples - numSamples);
+
+        if (bypassPrimeSamples == 0)
+            bypassMix.setTargetValue (bypassTarget ? 1.0f : 0.0f);
+
+        return;
+    }
+
+    // out = wet + (dry - wet) * mix, with the mix ramp in the scratch temp lane
+    const auto* mix = fillRamp (bypassMix, state.scratchBuffer.getWritePointer (0), numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* wet = block.getChannelPointer ((size_t) channel);
+        juce::FloatVectorOperations::subtract (dry[channel], wet, numSamples);
+        juce::FloatVectorOperations::multiply (dry[channel], mix, numSamples);
+        juce::FloatVectorOperations::add (wet, dry[channel], numSamples);
+    }
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::processBypassed (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state)
+{
+    // No gain stage and no oversampling: the audio only goes through the latency delay
+    warmDetector (block, state);
+
+    // Meter frames keep their length at the processing rate, showing the dry levels and no reduction
+    const int numSamples = (int) block.getNumSamples();
+    const int factor = 1 << activeOversamplingStages;
+
+    for (int start = 0; start < numSamples;)
+    {
+        const int samplesUntilFrame = meterAccumulator.getSamplesUntilFrame();
+        const int pieceSize = juce::jmin (numSamples - start, (samplesUntilFrame + factor - 1) / factor);
+        auto piece = block.getSubBlock ((size_t) start, (size_t) pieceSize);
+
+        meterAccumulator.addInput (piece);
+        state.bypassDelay.process (piece);
+        meterAccumulator.addOutput (piece);
+
+        for (int i = 0; i < linkLayout.numLanes; ++i)
+            meterAccumulator.addUnityGain (pieceSize * factor);
+
+        advanceMeter (juce::jmin (pieceSize * factor, samplesUntilFrame));
+        start += pieceSize;
+    }
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::warmDetector (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state)
+{
+    // A block-rate stand-in for the kernel: one level per channel, linked the way the
+    // kernel links, then one curve evaluation and a closed-form envelope step per lane.
+    // Re-engaging then starts close to the gain the compressor would have reached.
+    const int numSamples = (int) block.getNumSamples();
+    const int processingSamples = numSamples << activeOversamplingStages;
+    const int numChannels = juce::jmin ((int) block.getNumChannels(), linkLayout.numChannels);
+    const bool rms = detectionMode == SSLCompressorKernels::Detection::rms;
+
+    // Peak magnitude, or mean square for RMS, as the kernel's detection policies measure them
+    SampleType levels[SSLLinkLayout::maxChannels] {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* data = block.getChannelPointer ((size_t) channel);
+
+        if (rms)
         {
-            gainReductionDB = (*threshold + (inputLevelDB - *threshold) / *ratio) - inputLevelDB;
+            SampleType sum = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+                sum += data[i] * data[i];
+
+            levels[channel] = sum / (SampleType) juce::jmax (1, numSamples);
         }
-        
-        // Smooth the gain reduction using envelope detector
-        if (gainReductionDB < envelopeDetector)
-            envelopeDetector = attackCoeff * envelopeDetector + (1.0f - attackCoeff) * gainReductionDB;
         else
-            envelopeDetector = releaseCoeff * envelopeDetector + (1.0f - releaseCoeff) * gainReductionDB;
-        
-        // Convert back to linear gain
-        float gainReduction = std::pow(10.0f, (envelopeDetector + *makeupGain) / 20.0f);
-        
-        // Apply gain reduction to all channels
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+            levels[channel] = juce::jmax (-range.getStart(), range.getEnd());
+        }
+    }
+
+    if (linkLayout.linkAmount > 0.0f)
+    {
+        const auto amount = (SampleType) linkLayout.linkAmount;
+
+        for (int group = 0; group < linkLayout.numGroups; ++group)
+        {
+            const int size = linkLayout.groupSize[group];
+            const int* channels = linkLayout.groupChannels[group];
+            SampleType combined = levels[channels[0]];
+
+            for (int i = 1; i < size; ++i)
+                combined = linkMode == SSLCompressorKernels::StereoLink::average ? combined + levels[channels[i]]
+                                                                                 : juce::jmax (combined, levels[channels[i]]);
+
+            if (linkMode == SSLCompressorKernels::StereoLink::average)
+                combined /= (SampleType) size;
+
+            for (int i = 0; i < size; ++i)
+                levels[channels[i]] += (combined - levels[channels[i]]) * amount;
+        }
+    }
+
+    // Keep the ramps moving so nothing jumps when the compressor comes back
+    thresholdSmoother.skip (processingSamples);
+    slopeSmoother.skip (processingSamples);
+    makeupSmoother.skip (processingSamples);
+    driveSmoother.skip (processingSamples);
+
+    const auto thresholdDb = (SampleType) thresholdSmoother.getCurrentValue();
+    const auto slope = (SampleType) slopeSmoother.getCurrentValue();
+    const auto kneeDb = (SampleType) getApplied (kneeIndex);
+
+    for (int i = 0; i < linkLayout.numLanes; ++i)
+    {
+        const int lane = linkLayout.laneChannels[i];
+        auto& envelope = state.kernelState.envelope[lane];
+        SampleType level = levels[lane];
+
+        if (rms)
+        {
+            SSLGainComputer::stepMeanSquare (state.kernelState.meanSquare[lane], level, (SampleType) rmsCoeff, processingSamples);
+            level = std::sqrt (state.kernelState.meanSquare[lane]);
+        }
+
+        const auto levelDb = (SampleType) 20 * std::log10 (level + (SampleType) 1.0e-6);
+        const auto overDb = levelDb - thresholdDb + (topologyMode == SSLCompressorKernels::Topology::feedback ? envelope : (SampleType) 0);
+        const auto target = kneeDb > 0 ? SSLSoftKnee::curve (overDb, slope, kneeDb)
+                                       : SSLHardKnee::curve (overDb, slope, kneeDb);
+
+        SSLGainComputer::stepEnvelope (envelope, state.kernelState.held[lane], target, getBallistics<SampleType>(), processingSamples);
+    }
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::compressBlock (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state)
+{
+    const int numSamples = (int) block.getNumSamples();
+
+    // Split at meter frame boundaries so every frame covers the same time whatever the host block size
+    for (int start = 0; start < numSamples;)
+    {
+        const int segmentSize = juce::jmin (numSamples - start, meterAccumulator.getSamplesUntilFrame());
+        compressSegment (block.getSubBlock ((size_t) start, (size_t) segmentSize), state);
+        start += segmentSize;
+    }
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::compressSegment (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state)
+{
+    const int numSamples = (int) segment.getNumSamples();
+    auto& scratch = state.scratchBuffer;
+
+    SSLKernelContext<SampleType> context;
+    context.lanes = state.detectorLanes;
+    context.temp = scratch.getWritePointer (0);
+    context.thresholdDb = fillRamp (thresholdSmoother, scratch.getWritePointer (1), numSamples);
+    context.slope = fillRamp (slopeSmoother, scratch.getWritePointer (2), numSamples);
+    context.makeupDb = fillRamp (makeupSmoother, scratch.getWritePointer (3), numSamples);
+    context.kneeDb = (SampleType) getApplied (kneeIndex);
+    context.ballistics = getBallistics<SampleType>();
+    context.rmsCoeff = (SampleType) rmsCoeff;
+    context.math = state.mathKernels;
+    context.link = &linkLayout;
+    context.lookahead = lookaheadSamples > 0 ? &state.lookaheadDelay : nullptr;
+
+    const double inputPeak = meterAccumulator.addInput (segment);
+
+    // The idle path only knows the full-band kernel; the bands always run their crossovers
+    if (numBands == 1 && fadingNumBands == 0 && isIdle (state, inputPeak, numSamples))
+    {
+        bool unchanged = processIdle (segment, state, context);
+
+        // Idle levels still go through the saturator, whose residual is small there but not 0,
+        // so a signal crossing between the paths keeps the same curve
+        if (saturate (segment, state))
+            unchanged = false;
+
+        if (unchanged)
+            meterAccumulator.addUnchangedOutput();
+        else
+            meterAccumulator.addOutput (segment);
+    }
+    else
+    {
+        if (fadingNumBands > 0)
+            processBandFade (segment, state, context);
+        else if (numBands > 1)
+            compressBands (segment, state, context, *state.currentBands);
+        else
+            state.processKernel (segment, state.kernelState, context);
+
+        saturate (segment, state);
+        meterAccumulator.addOutput (segment);
+
+        // After the kernel the detector lanes hold the applied gain
+        for (int i = 0; i < linkLayout.numLanes; ++i)
+            meterAccumulator.addGain (context.lanes[linkLayout.laneChannels[i]], numSamples, context.makeupDb[numSamples - 1]);
+    }
+
+    advanceMeter (numSamples);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::compressBands (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state,
+                                                 const SSLKernelContext<SampleType>& context, BandPath<SampleType>& path)
+{
+    SSLMultibandContext<SampleType> bandContext { context, &path.crossover, state.bandBuffer.getArrayOfWritePointers(), state.bandLevels };
+    bandContext.lookahead = lookaheadSamples > 0 ? &path.lookahead : nullptr;
+
+    state.processBandKernel (segment, path.state, bandContext);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::processBandFade (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state,
+                                                   const SSLKernelContext<SampleType>& context)
+{
+    // Both layouts run, the outgoing one on a copy, then the incoming one in place so the
+    // lanes are left holding its gain for the meters
+    const int numSamples = (int) segment.getNumSamples();
+    const int numChannels = (int) segment.getNumChannels();
+    auto* const* outgoing = state.fadeBuffer.getArrayOfWritePointers();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::copy (outgoing[channel], segment.getChannelPointer ((size_t) channel), numSamples);
+
+    const juce::dsp::AudioBlock<SampleType> outgoingBlock (outgoing, (size_t) numChannels, (size_t) numSamples);
+
+    if (fadingNumBands > 1)
+        compressBands (outgoingBlock, state, context, *state.fadingBands);
+    else
+        state.processKernel (outgoingBlock, state.kernelState, context);
+
+    if (numBands > 1)
+        compressBands (segment, state, context, *state.currentBands);
+    else
+        state.processKernel (segment, state.kernelState, context);
+
+    if (bandPrimeSamples > 0)
+    {
+        // Keep the outgoing layout until the incoming one's delay lines hold real audio, then start the fade
         for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::copy (segment.getChannelPointer ((size_t) channel), outgoing[channel], numSamples);
+
+        bandPrimeSamples = juce::jmax (0, bandPrimeSamples - numSamples);
+
+        if (bandPrimeSamples == 0)
+            bandFade.setTargetValue (0.0f);
+
+        return;
+    }
+
+    // out = incoming + (outgoing - incoming) * fade, with the fade ramp in the scratch temp lane
+    const auto* fade = fillRamp (bandFade, state.scratchBuffer.getWritePointer (0), numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* incoming = segment.getChannelPointer ((size_t) channel);
+        juce::FloatVectorOperations::subtract (outgoing[channel], incoming, numSamples);
+        juce::FloatVectorOperations::multiply (outgoing[channel], fade, numSamples);
+        juce::FloatVectorOperations::add (incoming, outgoing[channel], numSamples);
+    }
+
+    if (! bandFade.isSmoothing())
+        fadingNumBands = 0;
+}
+
+void SSLCompressorAudioProcessor::advanceMeter (int numSamples)
+{
+    SSLMeterFrame frame;
+
+    if (meterAccumulator.advance (numSamples, frame))
+    {
+        currentGainReduction.store (frame.gainReductionPeakDb, std::memory_order_relaxed);
+        meterFifo.push (frame);
+    }
+}
+
+// Returns false when the stage is out and the segment was left as it was.
+template <typename SampleType>
+bool SSLCompressorAudioProcessor::saturate (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state)
+{
+    const int numSamples = (int) segment.getNumSamples();
+    const int numChannels = juce::jmin ((int) segment.getNumChannels(), linkLayout.numChannels);
+    auto& previous = state.saturatorState.previous;
+
+    // Drive settled at 0: the stage is an identity, but the last samples are kept so
+    // re-engaging starts from them
+    if (! driveSmoother.isSmoothing() && driveSmoother.getTargetValue() == 0.0)
+    {
+        driveSmoother.skip (numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            previous[channel] = segment.getChannelPointer ((size_t) channel)[numSamples - 1];
+
+        return false;
+    }
+
+    // The kernel is done with the temp lane
+    auto& scratch = state.scratchBuffer;
+    const auto* curveGain = fillRamp (driveSmoother, scratch.getWritePointer (4), numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        SSLSaturator::process (segment.getChannelPointer ((size_t) channel), curveGain, scratch.getWritePointer (0),
+                               previous[channel], numSamples);
+
+    return true;
+}
+
+template <typename SampleType>
+bool SSLCompressorAudioProcessor::isIdle (ProcessingState<SampleType>& state, double inputPeak, int numSamples)
+{
+    // A segment is quiet when none of its detector levels can exceed idleLevel. For RMS
+    // that also needs every mean square to start at zero; the peak limit then keeps
+    // them under idleLevel squared, so the kernel would snap them back to zero.
+    const auto& kernelState = state.kernelState;
+    bool quiet = inputPeak <= quietLevel;
+
+    if (detectionMode == SSLCompressorKernels::Detection::rms)
+        for (int i = 0; i < linkLayout.numLanes && quiet; ++i)
+            quiet = kernelState.meanSquare[linkLayout.laneChannels[i]] == (SampleType) 0;
+
+    const int quietBefore = state.quietSamples;
+    state.quietSamples = quiet ? (int) juce::jmin ((juce::int64) quietBefore + numSamples, (juce::int64) std::numeric_limits<int>::max()) : 0;
+
+    // The lookahead window reaches back 'delay' samples, which must all have been quiet too
+    if (! quiet || quietBefore < state.lookaheadDelay.getDelay())
+        return false;
+
+    // Every level is under the curve, so only an envelope already at exactly 0 dB stays there
+    for (int i = 0; i < linkLayout.numLanes; ++i)
+        if (kernelState.envelope[linkLayout.laneChannels[i]] != (SampleType) 0)
+            return false;
+
+    return true;
+}
+
+// Returns true when the segment went through untouched; the caller meters the output.
+template <typename SampleType>
+bool SSLCompressorAudioProcessor::processIdle (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state,
+                                               const SSLKernelContext<SampleType>& context)
+{
+    // Bit-identical to the kernel for an idle segment: every lane's gain change is 0 dB,
+    // so each lane would hold the makeup gain alone. The detector windows are left as
+    // they are; the levels skipped here are all quiet and can never be a deciding maximum.
+    const int numSamples = (int) segment.getNumSamples();
+    const int numChannels = juce::jmin ((int) segment.getNumChannels(), linkLayout.numChannels);
+
+    // Nothing is being reduced, so the auto release hold decays sample by sample as in the kernel
+    for (int i = 0; i < linkLayout.numLanes; ++i)
+        SSLGainComputer::releaseHold (state.kernelState.held[linkLayout.laneChannels[i]], context.ballistics, numSamples);
+
+    if (context.lookahead != nullptr)
+        context.lookahead->processAudio (segment);
+
+    if (state.unityAtZeroDb && ! makeupSmoother.isSmoothing() && makeupSmoother.getTargetValue() == 0.0f)
+    {
+        // Unity gain: nothing to multiply, and only the lookahead moves the audio
+        for (int i = 0; i < linkLayout.numLanes; ++i)
+            meterAccumulator.addUnityGain (numSamples);
+
+        return context.lookahead == nullptr;
+    }
+
+    auto* gain = context.lanes[linkLayout.laneChannels[0]];
+    juce::FloatVectorOperations::clear (gain, numSamples);
+    SSLGainComputer::decibelsToGain (gain, numSamples, context.makeupDb, context.math);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::multiply (segment.getChannelPointer ((size_t) channel), gain, numSamples);
+
+    for (int i = 0; i < linkLayout.numLanes; ++i)
+        meterAccumulator.addGain (gain, numSamples, context.makeupDb[numSamples - 1]);
+
+    return false;
+}
+
+template <typename SampleType, typename RampType>
+const SampleType* SSLCompressorAudioProcessor::fillRamp (juce::SmoothedValue<RampType>& smoother, SampleType* dest, int numSamples)
+{
+    if (smoother.isSmoothing())
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = (SampleType) smoother.getNextValue();
+    }
+    else
+    {
+        juce::FloatVectorOperations::fill (dest, (SampleType) smoother.getTargetValue(), numSamples);
+    }
+
+    return dest;
+}
+
+void SSLCompressorAudioProcessor::selectMathKernels (int precisionIndex)
+{
+    const auto tier = static_cast<SSLFastMath::Precision> (precisionIndex);
+    floatState.mathKernels = SSLFastMath::getKernels<float> (tier);
+    doubleState.mathKernels = SSLFastMath::getKernels<double> (tier);
+    floatState.unityAtZeroDb = SSLGainComputer::isUnityAtZeroDb (floatState.mathKernels);
+    doubleState.unityAtZeroDb = SSLGainComputer::isUnityAtZeroDb (doubleState.mathKernels);
+}
+
+void SSLCompressorAudioProcessor::selectKernel()
+{
+    detectionMode = static_cast<SSLCompressorKernels::Detection> ((int) getApplied (detectionIndex));
+    topologyMode = static_cast<SSLCompressorKernels::Topology> ((int) getApplied (topologyIndex));
+    linkMode = static_cast<SSLCompressorKernels::StereoLink> ((int) getApplied (stereoLinkIndex));
+    const bool softKnee = getApplied (kneeIndex) > 0.0f;
+
+    floatState.processKernel = SSLCompressorKernels::select<float> (detectionMode, topologyMode, softKnee, linkMode);
+    doubleState.processKernel = SSLCompressorKernels::select<double> (detectionMode, topologyMode, softKnee, linkMode);
+    floatState.processBandKernel = SSLMultibandKernels::select<float> (detectionMode, topologyMode, softKnee, linkMode);
+    doubleState.processBandKernel = SSLMultibandKernels::select<double> (detectionMode, topologyMode, softKnee, linkMode);
+
+    // RMS input must stay at half the idle level so its mean square stays under the snap level
+    quietLevel = (float) (detectionMode == SSLCompressorKernels::Detection::rms ? 0.5 * SSLGainComputer::idleLevel
+                                                                                : SSLGainComputer::idleLevel);
+}
+
+void SSLCompressorAudioProcessor::updateLinkLayout()
+{
+    int previousLaneOfChannel[SSLLinkLayout::maxChannels];
+    std::copy (std::begin (linkLayout.laneOfChannel), std::end (linkLayout.laneOfChannel), previousLaneOfChannel);
+
+    linkLayout.update (channelTypes, numLinkChannels,
+                       static_cast<SSLLinkLayout::Groups> ((int) getApplied (linkGroupsIndex)),
+                       getApplied (linkAmountIndex) / 100.0f);
+
+    remapLanes (floatState, previousLaneOfChannel);
+    remapLanes (doubleState, previousLaneOfChannel);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::remapLanes (ProcessingState<SampleType>& state, const int* previousLaneOfChannel)
+{
+    // Moving the link amount inside a mode keeps the lanes; only a remap needs new state.
+    // Each lane then continues from the envelope its channel was following, so the gain doesn't jump.
+    const auto previousState = state.kernelState;
+    bool remapped = false;
+
+    for (int channel = 0; channel < numLinkChannels; ++channel)
+    {
+        const int lane = linkLayout.laneOfChannel[channel];
+        const int previousLane = previousLaneOfChannel[channel];
+
+        if (lane == channel)
         {
-            float* channelData = buffer.getWritePointer(channel);
-            channelData[sample] *= gainReduction;
+            state.kernelState.envelope[lane] = previousState.envelope[previousLane];
+            state.kernelState.held[lane] = previousState.held[previousLane];
+            state.kernelState.meanSquare[lane] = previousState.meanSquare[previousLane];
+        }
+
+        remapped = remapped || lane != previousLane;
+    }
+
+    if (remapped)
+    {
+        state.lookaheadDelay.resetDetectors();
+
+        for (auto& path : state.bandPaths)
+            path.lookahead.resetDetectors();
+    }
+
+    // The band detectors of both layouts follow their channels the same way
+    for (auto& path : state.bandPaths)
+    {
+        const auto previousBandState = path.state;
+
+        for (int channel = 0; channel < numLinkChannels; ++channel)
+        {
+            const int lane = linkLayout.laneOfChannel[channel];
+            const int previousLane = previousLaneOfChannel[channel];
+
+            if (lane == channel)
+            {
+                std::copy (std::begin (previousBandState.envelope[previousLane]), std::end (previousBandState.envelope[previousLane]),
+                           path.state.envelope[lane]);
+                std::copy (std::begin (previousBandState.held[previousLane]), std::end (previousBandState.held[previousLane]),
+                           path.state.held[lane]);
+                std::copy (std::begin (previousBandState.meanSquare[previousLane]), std::end (previousBandState.meanSquare[previousLane]),
+                           path.state.meanSquare[lane]);
+            }
         }
     }
 }
 
+void SSLCompressorAudioProcessor::updateBands (bool crossfade)
+{
+    const int previousNumBands = numBands;
+    numBands = (int) getApplied (bandsIndex) + 1;
+
+    // Without a crossfade the current layout takes over at once, ending any fade still running
+    if (! crossfade)
+    {
+        fadingNumBands = 0;
+        bandPrimeSamples = 0;
+    }
+
+    if (numBands != previousNumBands)
+    {
+        switchBands (floatState, previousNumBands, crossfade);
+        switchBands (doubleState, previousNumBands, crossfade);
+
+        if (crossfade)
+        {
+            // The lookahead runs inside the oversampled section, as does the fade
+            fadingNumBands = previousNumBands;
+            bandPrimeSamples = lookaheadSamples << activeOversamplingStages;
+            bandFade.setCurrentAndTargetValue (1.0f);
+
+            if (bandPrimeSamples == 0)
+                bandFade.setTargetValue (0.0f);
+        }
+    }
+
+    // Retuning keeps the filter state, so sweeping a crossover doesn't click
+    const float frequencies[] = { getApplied (crossoverLowIndex), getApplied (crossoverMidIndex), getApplied (crossoverHighIndex) };
+    floatState.currentBands->crossover.setFrequencies (frequencies, numBands - 1, processingRate);
+    doubleState.currentBands->crossover.setFrequencies (frequencies, numBands - 1, processingRate);
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::switchBands (ProcessingState<SampleType>& state, int previousNumBands, bool crossfade)
+{
+    // The filters and delay lines of the incoming layout hold stale audio, so they restart.
+    // A crossfade keeps the outgoing layout running as it was, in the fading slot when it
+    // has bands; without one everything restarts.
+    // The detectors carry over: bands entering from the full band start at its reduction
+    // with an even share of its power, and the full band takes the deepest band's
+    // reduction and the total power, so the gain doesn't jump. The auto release hold
+    // goes with the reduction: copied into the bands, the longest held back out.
+    if (crossfade && previousNumBands > 1)
+    {
+        std::swap (state.currentBands, state.fadingBands);
+        state.currentBands->state = state.fadingBands->state;
+    }
+
+    if (numBands > 1 || ! crossfade)
+    {
+        state.currentBands->crossover.reset();
+        state.currentBands->lookahead.reset();
+    }
+
+    if (numBands == 1 || ! crossfade)
+        state.lookaheadDelay.reset();
+
+    state.quietSamples = 0;
+
+    auto& full = state.kernelState;
+    auto& split = state.currentBands->state;
+
+    for (int lane = 0; lane < SSLLinkLayout::maxChannels; ++lane)
+    {
+        if (previousNumBands == 1)
+        {
+            for (int band = 0; band < numBands; ++band)
+            {
+                split.envelope[lane][band] = full.envelope[lane];
+                split.held[lane][band] = full.held[lane];
+                split.meanSquare[lane][band] = full.meanSquare[lane] / (SampleType) numBands;
+            }
+        }
+        else if (numBands == 1)
+        {
+            full.envelope[lane] = *std::min_element (split.envelope[lane], split.envelope[lane] + previousNumBands);
+            full.held[lane] = *std::max_element (split.held[lane], split.held[lane] + previousNumBands);
+            full.meanSquare[lane] = std::accumulate (split.meanSquare[lane], split.meanSquare[lane] + previousNumBands, (SampleType) 0);
+        }
+    }
+}
+
+void SSLCompressorAudioProcessor::updateEnvelopeCoefficients()
+{
+    // Calculate time constants
+    const double attackTime = getApplied (attackIndex) / 1000.0;  // Convert to seconds
+    const bool autoRelease = isAutoRelease (getApplied (releaseIndex));
+    const double fastReleaseTime = autoRelease ? autoFastReleaseSeconds : getApplied (releaseIndex) / 1000.0;
+    const double slowReleaseTime = autoRelease ? autoSlowReleaseSeconds : fastReleaseTime;
+
+    ballistics.attack = std::exp (-1.0 / (processingRate * attackTime));
+    ballistics.fastRelease = std::exp (-1.0 / (processingRate * fastReleaseTime));
+    ballistics.slowRelease = std::exp (-1.0 / (processingRate * slowReleaseTime));
+    ballistics.holdRise = std::exp (-1.0 / (processingRate * autoHoldRiseSeconds));
+    ballistics.holdFall = std::exp (-1.0 / (processingRate * autoHoldFallSeconds));
+    rmsCoeff = std::exp (-1.0 / (processingRate * rmsWindowSeconds));
+}
+
+bool SSLCompressorAudioProcessor::isAutoRelease (float releaseMs) noexcept
+{
+    return releaseMs > maxReleaseMs;
+}
+
+template <typename SampleType>
+SSLBallistics<SampleType> SSLCompressorAudioProcessor::getBallistics() const noexcept
+{
+    return { (SampleType) ballistics.attack, (SampleType) ballistics.fastRelease,
+             (SampleType) ballistics.slowRelease, (SampleType) ballistics.holdRise, (SampleType) ballistics.holdFall };
+}
+
+int SSLCompressorAudioProcessor::getLookaheadSamples() const
+{
+    return juce::roundToInt (getApplied (lookaheadIndex) * 0.001 * sampleRate);
+}
+
+int SSLCompressorAudioProcessor::getOversamplingStages() const
+{
+    // Offline renders never use less oversampling than live playback
+    const int liveStages = (int) getApplied (oversamplingIndex);
+    return isNonRealtime() ? juce::jmax (liveStages, (int) getApplied (renderOversamplingIndex)) : liveStages;
+}
+
+void SSLCompressorAudioProcessor::updateProcessingSetup()
+{
+    const int stages = getOversamplingStages();
+    const int filter = (int) getApplied (oversamplingFilterIndex);
+    const double rate = sampleRate * (1 << stages);
+
+    // Each rebuild is audible (the oversampler restarts, the ramps snap), so each only happens when
+    // what it depends on really changed, not e.g. on a recall that leaves the oversampling alone
+    if (stages != activeOversamplingStages || filter != activeOversamplingFilter || rate != processingRate)
+    {
+        activeOversamplingStages = stages;
+        activeOversamplingFilter = filter;
+
+        // Only the prepared precision has oversamplers; both report the same latency for the same design
+        oversamplingLatency = juce::roundToInt (juce::jmax (activateOversampler (floatState), activateOversampler (doubleState)));
+    }
+
+    if (rate != processingRate)
+    {
+        // Envelope and ramps run at the oversampled rate
+        processingRate = rate;
+        thresholdSmoother.reset (processingRate, parameterSmoothingSeconds);
+        slopeSmoother.reset (processingRate, parameterSmoothingSeconds);
+        makeupSmoother.reset (processingRate, parameterSmoothingSeconds);
+        driveSmoother.reset (processingRate, parameterSmoothingSeconds);
+        bandFade.reset (processingRate, bandFadeSeconds);
+        meterAccumulator.prepare (processingRate);
+
+        coefficientsDirty = false;
+        updateEnvelopeCoefficients();
+
+        // The crossovers are tuned at the processing rate too, and a band crossfade ends
+        bandsDirty = false;
+        updateBands (false);
+    }
+
+    // The lookahead length is in oversampled samples
+    lookaheadDirty = false;
+    updateLatency();
+}
+
+// A lookahead change only moves the delays and the reported latency
+void SSLCompressorAudioProcessor::updateLatency()
+{
+    lookaheadSamples = getLookaheadSamples();
+    const int latencySamples = lookaheadSamples + oversamplingLatency;
+
+    updateDelays (floatState, latencySamples);
+    updateDelays (doubleState, latencySamples);
+    setLatencySamples (latencySamples);
+}
+
+template <typename SampleType>
+float SSLCompressorAudioProcessor::activateOversampler (ProcessingState<SampleType>& state)
+{
+    state.activeOversampler = activeOversamplingStages > 0 ? state.oversamplers[activeOversamplingFilter][activeOversamplingStages - 1].get()
+                                                           : nullptr;
+
+    if (state.activeOversampler == nullptr)
+        return 0.0f;
+
+    state.activeOversampler->reset();
+    return (float) state.activeOversampler->getLatencyInSamples();
+}
+
+template <typename SampleType>
+void SSLCompressorAudioProcessor::updateDelays (ProcessingState<SampleType>& state, int latencySamples)
+{
+    // Only the prepared precision has delay lines
+    if (state.scratchBuffer.getNumChannels() == 0)
+        return;
+
+    // The lookahead runs inside the oversampled section, so its length scales with the factor
+    const int lookaheadDelay = lookaheadSamples << activeOversamplingStages;
+
+    // Without lookahead the rings are not written, so they hold whatever played before it was
+    // turned off. Clear them, and restart the quiet count so the idle path waits for a full window.
+    if (lookaheadDelay > 0 && state.lookaheadDelay.getDelay() == 0)
+    {
+        state.lookaheadDelay.reset();
+
+        for (auto& path : state.bandPaths)
+            path.lookahead.reset();
+
+        state.quietSamples = 0;
+    }
+
+    state.lookaheadDelay.setDelay (lookaheadDelay);
+
+    for (auto& path : state.bandPaths)
+        path.lookahead.setDelay (lookaheadDelay);
+
+    // The bypassed signal is delayed by everything the compressor adds, so bypassing never shifts it
+    state.bypassDelay.setDelay (latencySamples);
+}
+
+//==============================================================================
+bool SSLCompressorAudioProcessor::getBlockStats (SSLBlockStats& stats) const
+{
+   #if SSL_INSTRUMENTATION
+    blockProbe.read (stats);
+    return true;
+   #else
+    juce::ignoreUnused (stats);
+    return false;
+   #endif
+}
+
+void SSLCompressorAudioProcessor::resetBlockStats()
+{
+   #if SSL_INSTRUMENTATION
+    blockProbe.reset();
+   #endif
+}
+
 //==============================================================================
 juce::AudioProcessorEditor* SSLCompressorAudioProcessor::createEditor()
 {
-    return new juce::GenericAudioProcessorEditor(*this);
+    return new SSLCompressorAudioProcessorEditor(*this);
 }
 
 bool SSLCompressorAudioProcessor::hasEditor() const
@@ -180,40 +1475,143 @@ bool SSLCompressorAudioProcessor::isMidiEffect() const
 
 double SSLCompressorAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // After the input stops the delayed audio drains, then the envelope releases from
+    // the reduction a full-scale input would cause down to settledDb, where it snaps to
+    // 0 dB and the idle path takes over. Suspending the plugin after that changes nothing.
+    const double rate = getSampleRate();
+    const double latencySeconds = rate > 0.0 ? getLatencySamples() / rate : 0.0;
+
+    const double reductionDb = threshold->get() * SSLGainComputer::getSlope (ratio->get());
+    const double releaseSeconds = (isAutoRelease (release->get()) ? autoSlowReleaseSeconds : release->get() / 1000.0)
+                                    * std::log (juce::jmax (1.0, reductionDb / SSLGainComputer::settledDb));
+
+    // The RMS mean square decays from full scale to the idle snap level
+    const double rmsSeconds = detection->getIndex() == (int) SSLCompressorKernels::Detection::rms
+                                ? rmsWindowSeconds * std::log (1.0 / (SSLGainComputer::idleLevel * SSLGainComputer::idleLevel))
+                                : 0.0;
+
+    return latencySeconds + juce::jmax (releaseSeconds, rmsSeconds);
 }
 
 //==============================================================================
 int SSLCompressorAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return SSLFactoryPresets::numPresets;
 }
 
 int SSLCompressorAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void SSLCompressorAudioProcessor::setCurrentProgram (int index)
 {
+    if (! juce::isPositiveAndBelow (index, SSLFactoryPresets::numPresets))
+        return;
+
+    currentProgram = index;
+    recallSnapshot (factorySnapshots[index], false);
 }
 
 const juce::String SSLCompressorAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return juce::isPositiveAndBelow (index, SSLFactoryPresets::numPresets) ? SSLFactoryPresets::bank[index].name : "";
 }
 
 void SSLCompressorAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    // The factory bank is read-only
+}
+
+//==============================================================================
+void SSLCompressorAudioProcessor::selectCompareSlot (int slot)
+{
+    if (slot == compareSlot || ! juce::isPositiveAndBelow (slot, 2))
+        return;
+
+    StateSnapshot edited;
+    captureSnapshot (edited);
+
+    compareSlot = slot;
+    recallSnapshot (compareSnapshot, false);
+    compareSnapshot = edited;
+}
+
+void SSLCompressorAudioProcessor::copyToOtherCompareSlot()
+{
+    captureSnapshot (compareSnapshot);
+}
+
+void SSLCompressorAudioProcessor::captureSnapshot (StateSnapshot& snapshot) const
+{
+    for (int i = 0; i < numStateParameters; ++i)
+        snapshot.values[i] = stateParameters[i]->convertFrom0to1 (stateParameters[i]->getValue());
+}
+
+void SSLCompressorAudioProcessor::recallSnapshot (const StateSnapshot& snapshot, bool includeSetup)
+{
+    const juce::SpinLock::ScopedLockType lock (recallLock);
+
+    // The slot gets every value as the parameter will hold it once written, and what the
+    // recall leaves alone as it is now, before any parameter moves
+    for (int i = 0; i < numStateParameters; ++i)
+    {
+        auto* parameter = stateParameters[i];
+        const bool recalled = includeSetup || ! stateParameterTable[i].isSetup;
+
+        recallValues[i].store (recalled ? parameter->convertFrom0to1 (parameter->convertTo0to1 (snapshot.values[i]))
+                                        : rawStateValues[i]->load(),
+                               std::memory_order_relaxed);
+    }
+
+    recallSerial.fetch_add (1, std::memory_order_release);
+
+    // Only parameters that actually change notify the host and the editor, so a session
+    // full of instances near their defaults loads with very few notifications
+    for (int i = 0; i < numStateParameters; ++i)
+    {
+        if (stateParameterTable[i].isSetup && ! includeSetup)
+            continue;
+
+        auto* parameter = stateParameters[i];
+        const float value = parameter->convertTo0to1 (snapshot.values[i]);
+
+        if (value != parameter->getValue())
+            parameter->setValueNotifyingHost (value);
+    }
+
+    recallSerial.fetch_add (1, std::memory_order_release);
 }
 
 //==============================================================================
 void SSLCompressorAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // Store parameter values
+    // Both A/B slots as plain values behind a short header, see SSLStateFormat
+    StateSnapshot slots[2];
+    captureSnapshot (slots[compareSlot]);
+    slots[1 - compareSlot] = compareSnapshot;
+
+    SSLStateFormat::Header header;
+    header.numValues = numStateParameters;
+    header.activeSlot = compareSlot;
+    header.program = currentProgram;
+
+    destData.setSize (SSLStateFormat::getSize (numStateParameters));
+    SSLStateFormat::write (destData.getData(), header, slots[0].values, slots[1].values);
 }
 
 void SSLCompressorAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // Restore parameter values
+    // Parameters the state doesn't hold keep their defaults
+    StateSnapshot slots[2] { defaultSnapshot, defaultSnapshot };
+    SSLStateFormat::Header header;
+
+    if (sizeInBytes <= 0 || ! SSLStateFormat::read (data, (size_t) sizeInBytes, numStateParameters,
+                                                     header, slots[0].values, slots[1].values))
+        return;
+
+    compareSlot = header.activeSlot;
+    currentProgram = juce::jlimit (0, SSLFactoryPresets::numPresets - 1, header.program);
+    compareSnapshot = slots[1 - compareSlot];
+    recallSnapshot (slots[compareSlot], true);
 }
\ No newline at end of file
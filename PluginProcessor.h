@@ -1,6 +1,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Multiband.h"
+#include "Metering.h"
+#include "Saturation.h"
+#include "Presets.h"
+#include "Instrumentation.h"
 
 //==============================================================================
 class SSLCompressorAudioProcessor  : public juce::AudioProcessor
@@ -13,7 +18,14 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+    bool supportsDoublePrecisionProcessing() const override     { return true; }
+    void setNonRealtime (bool isNonRealtime) noexcept override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -38,20 +50,282 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    // Parameter IDs
+    static constexpr const char* PARAM_THRESHOLD = "threshold";
+    static constexpr const char* PARAM_RATIO = "ratio";
+    static constexpr const char* PARAM_ATTACK = "attack";
+    static constexpr const char* PARAM_RELEASE = "release";
+    static constexpr const char* PARAM_MAKEUP = "makeup";
+    static constexpr const char* PARAM_PRECISION = "precision";
+    static constexpr const char* PARAM_LOOKAHEAD = "lookahead";
+    static constexpr const char* PARAM_OVERSAMPLING = "oversampling";
+    static constexpr const char* PARAM_RENDER_OVERSAMPLING = "renderOversampling";
+    static constexpr const char* PARAM_OVERSAMPLING_FILTER = "oversamplingFilter";
+    static constexpr const char* PARAM_DETECTION = "detection";
+    static constexpr const char* PARAM_TOPOLOGY = "topology";
+    static constexpr const char* PARAM_KNEE = "knee";
+    static constexpr const char* PARAM_STEREO_LINK = "stereoLink";
+    static constexpr const char* PARAM_LINK_AMOUNT = "linkAmount";
+    static constexpr const char* PARAM_LINK_GROUPS = "linkGroups";
+    static constexpr const char* PARAM_BYPASS = "bypass";
+    static constexpr const char* PARAM_BANDS = "bands";
+    static constexpr const char* PARAM_CROSSOVER_LOW = "crossoverLow";
+    static constexpr const char* PARAM_CROSSOVER_MID = "crossoverMid";
+    static constexpr const char* PARAM_CROSSOVER_HIGH = "crossoverHigh";
+    static constexpr const char* PARAM_DRIVE = "drive";
+
+    // Owns all parameters; the typed pointers below point into it
+    juce::AudioProcessorValueTreeState parameters;
+
     // Compressor parameters
     juce::AudioParameterFloat* threshold;
     juce::AudioParameterFloat* ratio;
     juce::AudioParameterFloat* attack;
     juce::AudioParameterFloat* release;
     juce::AudioParameterFloat* makeupGain;
+    juce::AudioParameterChoice* precision;
+    juce::AudioParameterFloat* lookahead;
+    juce::AudioParameterChoice* oversampling;
+    juce::AudioParameterChoice* renderOversampling;
+    juce::AudioParameterChoice* oversamplingFilter;
+    juce::AudioParameterChoice* detection;
+    juce::AudioParameterChoice* topology;
+    juce::AudioParameterFloat* knee;
+    juce::AudioParameterChoice* stereoLink;
+    juce::AudioParameterFloat* linkAmount;
+    juce::AudioParameterChoice* linkGroups;
+    juce::AudioParameterBool* bypass;
+    juce::AudioParameterChoice* bands;
+    juce::AudioParameterFloat* crossoverLow;
+    juce::AudioParameterFloat* crossoverMid;
+    juce::AudioParameterFloat* crossoverHigh;
+    juce::AudioParameterFloat* drive;
+
+    // Metering: latest gain reduction for anyone polling, and the frame stream the editor drains
+    float getCurrentGainReductionDb() const noexcept    { return currentGainReduction.load (std::memory_order_relaxed); }
+    SSLMeterFifo& getMeterFifo() noexcept               { return meterFifo; }
+
+    // A/B compare, message thread only: the live parameters are the selected slot and
+    // the other slot is held here. Like the presets, it leaves the setup parameters alone.
+    int getCompareSlot() const noexcept                 { return compareSlot; }
+    void selectCompareSlot (int slot);
+    void copyToOtherCompareSlot();
+
+    // Per-block timing and real-time safety counts, readable from any thread. Only builds
+    // with SSL_INSTRUMENTATION collect them; elsewhere getBlockStats returns false.
+    bool getBlockStats (SSLBlockStats& stats) const;
+    void resetBlockStats();
+
+    static constexpr float maxLookaheadMs = 10.0f;
+
+    // Release beyond maxReleaseMs is the knob's last position, Auto, stored as autoReleaseMs.
+    // Auto moves between a fast and a slow release as reduction is held (see GainComputer.h);
+    // the hold state rises and falls with the two hold time constants.
+    static constexpr float maxReleaseMs = 1000.0f;
+    static constexpr float autoReleaseMs = 1100.0f;
+    static constexpr double autoFastReleaseSeconds = 0.1;
+    static constexpr double autoSlowReleaseSeconds = 1.2;
+    static constexpr double autoHoldRiseSeconds = 0.5;
+    static constexpr double autoHoldFallSeconds = 2.0;
+
+    static constexpr double parameterSmoothingSeconds = 0.02;
+    static constexpr double rmsWindowSeconds = 0.01;
+    static constexpr double bypassFadeSeconds = 0.01;
+    static constexpr double bandFadeSeconds = 0.01;
 
 private:
     // Compressor state variables
-    float currentGainReduction;
-    float envelopeDetector;
+    std::atomic<float> currentGainReduction { 0.0f };
     double sampleRate;
-    juce::AudioProcessorValueTreeState parameters;
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    int lookaheadSamples = 0;
+    int maxBlockSize = 0;
+    int numBands = 1;
+
+    // Scratch lanes: temp, threshold, slope, makeup and drive ramps, then one detector/gain lane per channel
+    static constexpr int numRampLanes = 5;
+
+    // Oversamplers for 2x/4x/8x, indexed [filter][stages - 1]: IIR polyphase, then FIR equiripple
+    static constexpr int numOversamplingFilters = 2;
+    static constexpr int maxOversamplingStages = 3;
+    int activeOversamplingStages = 0;
+    int activeOversamplingFilter = 0;
+    int oversamplingLatency = 0;
+
+    // One band layout: its crossovers, per-band detectors and lookahead. Each processing
+    // state has two, so a band count change can keep the outgoing layout running while
+    // the incoming one fades in.
+    template <typename SampleType>
+    struct BandPath
+    {
+        SSLMultibandState<SampleType> state;
+        SSLCrossover<SampleType> crossover;
+        SSLLookahead<SampleType> lookahead;
+    };
+
+    // Everything the DSP core keeps per sample type. Both exist so the float and
+    // double paths are compiled and vectorised separately, but only the precision
+    // the host processes in is given buffers in prepareToPlay.
+    template <typename SampleType>
+    struct ProcessingState
+    {
+        SSLKernelState<SampleType> kernelState;
+        SSLCompressorKernels::ProcessFunction<SampleType> processKernel = nullptr;
+        SSLFastMath::Kernels<SampleType> mathKernels = SSLFastMath::getKernels<SampleType> (SSLFastMath::Precision::high);
+        juce::AudioBuffer<SampleType> scratchBuffer;
+        SampleType* detectorLanes[SSLLinkLayout::maxChannels] {};
+        SSLLookahead<SampleType> lookaheadDelay;
+        std::unique_ptr<juce::dsp::Oversampling<SampleType>> oversamplers[numOversamplingFilters][maxOversamplingStages];
+        juce::dsp::Oversampling<SampleType>* activeOversampler = nullptr;
+
+        // Idle detection: consecutive quiet samples at the processing rate, and
+        // whether the math kernels turn 0 dB makeup into a gain of exactly 1
+        int quietSamples = 0;
+        bool unityAtZeroDb = false;
+
+        // Bypass: the dry signal, delayed by the reported latency, and a copy of it for the crossfade
+        SSLDelayLine<SampleType> bypassDelay;
+        juce::AudioBuffer<SampleType> dryBuffer;
+
+        // Multiband: the current and the fading band layout, the band signals and the interleaved band levels per lane
+        SSLMultibandKernels::ProcessFunction<SampleType> processBandKernel = nullptr;
+        BandPath<SampleType> bandPaths[2];
+        BandPath<SampleType>* currentBands = &bandPaths[0];
+        BandPath<SampleType>* fadingBands = &bandPaths[1];
+        juce::AudioBuffer<SampleType> bandBuffer;
+        juce::AudioBuffer<SampleType> bandLevelBuffer;
+        SampleType* bandLevels[SSLLinkLayout::maxChannels] {};
+
+        // Band count crossfade: the outgoing layout's output at the processing rate
+        juce::AudioBuffer<SampleType> fadeBuffer;
+
+        // Output saturation after the gain stage
+        SSLSaturatorState<SampleType> saturatorState;
+    };
+
+    ProcessingState<float> floatState;
+    ProcessingState<double> doubleState;
+
+    // Modes of the selected kernel, and the input peak a segment must stay under to count as quiet
+    SSLCompressorKernels::Detection detectionMode = SSLCompressorKernels::Detection::peak;
+    SSLCompressorKernels::Topology topologyMode = SSLCompressorKernels::Topology::feedForward;
+    SSLCompressorKernels::StereoLink linkMode = SSLCompressorKernels::StereoLink::maximum;
+    float quietLevel = 0.0f;
+
+    // Meter frames are measured at the processing rate and handed to the editor without locks
+    SSLMeterAccumulator meterAccumulator;
+    SSLMeterFifo meterFifo;
+
+    // Channel layout of the main bus, captured in prepareToPlay, and the detector linking derived from it
+    juce::AudioChannelSet::ChannelType channelTypes[SSLLinkLayout::maxChannels] {};
+    int numLinkChannels = 0;
+    SSLLinkLayout linkLayout;
+
+    // Envelope coefficients at the processing rate, recomputed only when attack/release or the rate change
+    double processingRate = 44100.0;
+    SSLBallistics<double> ballistics {};
+    double rmsCoeff = 0.0;
+
+    // Per-sample ramps for the static curve and makeup, running at the processing rate. They
+    // step in double so the double path gets double ramps; the float path rounds each value.
+    juce::SmoothedValue<double> thresholdSmoother, slopeSmoother, makeupSmoother;
+
+    // Saturation curve gain g, ramped at the processing rate; a settled 0 takes the stage out
+    juce::SmoothedValue<double> driveSmoother;
+
+    // Bypass crossfade at the host rate: 0 is processed, 1 is dry. The path being faded in
+    // first runs for the latency, so its delay lines hold real audio when it becomes audible.
+    juce::SmoothedValue<float> bypassMix;
+    bool bypassTarget = false;
+    int bypassPrimeSamples = 0;
+
+    // Band count crossfade at the processing rate: 1 is the outgoing layout, 0 the incoming one.
+    // fadingNumBands is the outgoing band count while a fade runs and 0 otherwise. As with the
+    // bypass, the incoming layout first runs for the lookahead before it is faded in.
+    juce::SmoothedValue<float> bandFade;
+    int fadingNumBands = 0;
+    int bandPrimeSamples = 0;
+
+    // Set by takeParameterValues / setNonRealtime, consumed at the start of the next block
+    std::atomic<bool> coefficientsDirty { true };
+    std::atomic<bool> precisionDirty { true };
+    std::atomic<bool> kernelDirty { true };
+    std::atomic<bool> setupDirty { true };
+    std::atomic<bool> lookaheadDirty { true };
+    std::atomic<bool> linkDirty { true };
+    std::atomic<bool> bandsDirty { true };
+
+    // Saved state, presets and A/B: every parameter in storage order (see PluginProcessor.cpp)
+    static constexpr int numStateParameters = 22;
+    using StateSnapshot = SSLParameterSnapshot<numStateParameters>;
+    juce::RangedAudioParameter* stateParameters[numStateParameters] {};
+    StateSnapshot defaultSnapshot;
+    StateSnapshot factorySnapshots[SSLFactoryPresets::numPresets];
+    StateSnapshot compareSnapshot;
+    int compareSlot = 0;
+    int currentProgram = 0;
+
+    // The parameter values the audio thread runs on, in storage order, taken as one set at the
+    // start of each block. Each parameter's raw value, and the derived state a change flags.
+    StateSnapshot appliedValues;
+    std::atomic<float>* rawStateValues[numStateParameters] {};
+    std::atomic<bool>* stateDirtyFlags[numStateParameters] {};
+
+    // A recall first writes the complete set it recalls into recallValues, then keeps
+    // recallSerial odd while it writes the parameters one at a time. Blocks meanwhile take
+    // their values from the slot, so none runs on half a preset.
+    std::atomic<float> recallValues[numStateParameters] {};
+    std::atomic<juce::uint32> recallSerial { 0 };
+    juce::SpinLock recallLock;
+
+   #if SSL_INSTRUMENTATION
+    SSLBlockProbe blockProbe;
+   #endif
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    std::atomic<bool>* getDirtyFlag (const juce::String& parameterID) noexcept;
+    bool takeParameterValues();
+    float getApplied (int stateIndex) const noexcept    { return appliedValues.values[stateIndex]; }
+    void selectMathKernels (int precisionIndex);
+    void selectKernel();
+    void updateLinkLayout();
+    void updateEnvelopeCoefficients();
+    static bool isAutoRelease (float releaseMs) noexcept;
+    template <typename SampleType> SSLBallistics<SampleType> getBallistics() const noexcept;
+    int getLookaheadSamples() const;
+    int getOversamplingStages() const;
+    void updateProcessingSetup();
+    void updateLatency();
+    void updateBands (bool crossfade);
+    void applyParameterChanges();
+    void captureSnapshot (StateSnapshot& snapshot) const;
+    void recallSnapshot (const StateSnapshot& snapshot, bool includeSetup);
+    bool isBypassSettled (bool bypassed) const noexcept;
+    void advanceMeter (int numSamples);
+
+    template <typename SampleType> void prepareState (ProcessingState<SampleType>& state, int numChannels);
+    template <typename SampleType> void releaseState (ProcessingState<SampleType>& state);
+    template <typename SampleType> void processSamples (juce::AudioBuffer<SampleType>& buffer, ProcessingState<SampleType>& state, bool hostBypassed);
+    template <typename SampleType> void updateBypass (ProcessingState<SampleType>& state, bool shouldBypass);
+    template <typename SampleType> void processWet (juce::dsp::AudioBlock<SampleType> block, ProcessingState<SampleType>& state);
+    template <typename SampleType> void processTransition (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state);
+    template <typename SampleType> void processBypassed (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state);
+    template <typename SampleType> void warmDetector (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state);
+    template <typename SampleType> void compressBlock (const juce::dsp::AudioBlock<SampleType>& block, ProcessingState<SampleType>& state);
+    template <typename SampleType> void compressSegment (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state);
+    template <typename SampleType> void compressBands (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state,
+                                                       const SSLKernelContext<SampleType>& context, BandPath<SampleType>& path);
+    template <typename SampleType> void processBandFade (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state,
+                                                         const SSLKernelContext<SampleType>& context);
+    template <typename SampleType> bool saturate (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state);
+    template <typename SampleType> bool isIdle (ProcessingState<SampleType>& state, double inputPeak, int numSamples);
+    template <typename SampleType> bool processIdle (const juce::dsp::AudioBlock<SampleType>& segment, ProcessingState<SampleType>& state,
+                                                     const SSLKernelContext<SampleType>& context);
+    template <typename SampleType> void remapLanes (ProcessingState<SampleType>& state, const int* previousLaneOfChannel);
+    template <typename SampleType> void switchBands (ProcessingState<SampleType>& state, int previousNumBands, bool crossfade);
+    template <typename SampleType> float activateOversampler (ProcessingState<SampleType>& state);
+    template <typename SampleType> void updateDelays (ProcessingState<SampleType>& state, int latencySamples);
+    template <typename SampleType, typename RampType>
+    static const SampleType* fillRamp (juce::SmoothedValue<RampType>& smoother, SampleType* dest, int numSamples);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SSLCompressorAudioProcessor)
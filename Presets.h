@@ -0,0 +1,168 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Saved state and the factory preset bank.
+//
+// A snapshot holds every parameter as a plain (real-world) value in a fixed
+// storage order owned by the processor. Plain values keep a saved state
+// meaningful if a parameter's range or skew changes later.
+//
+// The state is a 12-byte header followed by the two A/B compare slots, all
+// little-endian, so a session with hundreds of instances loads without any XML
+// or ValueTree parsing and without allocating. Reading and writing touch only
+// the caller's buffers.
+
+template <int numValues>
+struct SSLParameterSnapshot
+{
+    float values[numValues] {};
+};
+
+//==============================================================================
+struct SSLStateFormat
+{
+    static constexpr juce::uint32 magic = juce::ByteOrder::makeInt ('S', 'S', 'L', 'C');
+
+    // Bump when the meaning of a stored value changes, and migrate older states
+    // after reading them. New parameters don't need a bump: they are appended to
+    // the storage order, and states written before them leave them at the default.
+    static constexpr int currentVersion = 1;
+
+    // magic (4), version (2), values per slot (2), active slot (1), reserved (1), program (2)
+    static constexpr size_t headerSize = 12;
+
+    struct Header
+    {
+        int version = currentVersion;
+        int numValues = 0;
+        int activeSlot = 0;
+        int program = 0;
+    };
+
+    static size_t getSize (int numValues) noexcept
+    {
+        return headerSize + 2 * (size_t) numValues * sizeof (float);
+    }
+
+    // Writes header.numValues values from each slot; dest must hold getSize (header.numValues) bytes.
+    static void write (void* dest, const Header& header, const float* slotA, const float* slotB) noexcept
+    {
+        auto* bytes = static_cast<juce::uint8*> (dest);
+
+        writeInt (bytes, magic);
+        writeShort (bytes + 4, (juce::uint16) header.version);
+        writeShort (bytes + 6, (juce::uint16) header.numValues);
+        bytes[8] = (juce::uint8) header.activeSlot;
+        bytes[9] = 0;
+        writeShort (bytes + 10, (juce::uint16) header.program);
+
+        bytes += headerSize;
+
+        for (const float* slot : { slotA, slotB })
+        {
+            for (int i = 0; i < header.numValues; ++i, bytes += sizeof (float))
+            {
+                juce::uint32 bits;
+                std::memcpy (&bits, slot + i, sizeof (bits));
+                writeInt (bytes, bits);
+            }
+        }
+    }
+
+    // Reads a state written by this or an older version into slots of numValues,
+    // migrating each slot to currentVersion. A state with fewer values leaves the
+    // rest of each slot as the caller filled it, and one with more (from a newer
+    // build that only appended parameters) has its extra values ignored.
+    // Non-finite values are skipped the same way. A state from a newer version is
+    // rejected: its version was bumped because stored values changed meaning, so
+    // even its known prefix can't be trusted. Returns false, touching nothing but
+    // the header, if data isn't a complete state of a known version.
+    static bool read (const void* data, size_t size, int numValues, Header& header, float* slotA, float* slotB) noexcept
+    {
+        const auto* bytes = static_cast<const juce::uint8*> (data);
+
+        if (bytes == nullptr || size < headerSize || juce::ByteOrder::littleEndianInt (bytes) != magic)
+            return false;
+
+        header.version = juce::ByteOrder::littleEndianShort (bytes + 4);
+        header.numValues = juce::ByteOrder::littleEndianShort (bytes + 6);
+        header.activeSlot = bytes[8] != 0 ? 1 : 0;
+        header.program = (juce::int16) juce::ByteOrder::littleEndianShort (bytes + 10);
+
+        if (header.version < 1 || header.version > currentVersion || size < getSize (header.numValues))
+            return false;
+
+        const int numStored = header.numValues;
+        bytes += headerSize;
+
+        for (float* slot : { slotA, slotB })
+        {
+            for (int i = 0; i < juce::jmin (numValues, numStored); ++i)
+            {
+                const juce::uint32 bits = juce::ByteOrder::littleEndianInt (bytes + i * sizeof (float));
+                float value;
+                std::memcpy (&value, &bits, sizeof (value));
+
+                if (std::isfinite (value))
+                    slot[i] = value;
+            }
+
+            bytes += (size_t) numStored * sizeof (float);
+            migrate (header.version, slot, numValues);
+        }
+
+        return true;
+    }
+
+    // Brings a slot read from a state of the given version to the meaning of
+    // currentVersion, one version step at a time. Version 1 is the first format,
+    // so there is nothing to convert yet.
+    static void migrate (int version, float* slot, int numValues) noexcept
+    {
+        juce::ignoreUnused (version, slot, numValues);
+    }
+
+private:
+    static void writeInt (juce::uint8* dest, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian (value);
+        std::memcpy (dest, &value, sizeof (value));
+    }
+
+    static void writeShort (juce::uint8* dest, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian (value);
+        std::memcpy (dest, &value, sizeof (value));
+    }
+};
+
+//==============================================================================
+// Factory presets. They set the sound only: the processor keeps the setup
+// parameters (precision, oversampling, link groups, bypass) as they are, and
+// everything not listed here goes back to its default.
+struct SSLFactoryPreset
+{
+    const char* name;
+    float threshold, ratio, attack, release, makeup, knee, drive;
+    int detection, topology, bands;     // choice indices
+};
+
+struct SSLFactoryPresets
+{
+    static constexpr SSLFactoryPreset bank[] =
+    {
+        //  name               thresh  ratio  attack  release  makeup  knee   drive  det  topo  bands
+        { "Default",           -20.0f,  4.0f,  10.0f,  100.0f,  0.0f,  0.0f,   0.0f,  0,   0,    0 },
+        { "Mix Bus Glue",      -12.0f,  2.0f,  30.0f,  300.0f,  2.0f,  6.0f,   0.0f,  0,   0,    0 },
+        { "Drum Bus Punch",    -18.0f,  4.0f,  10.0f,  100.0f,  4.0f,  0.0f,  10.0f,  0,   0,    0 },
+        { "Drum Smash",        -36.0f, 10.0f,   0.1f,  100.0f, 12.0f,  0.0f,  30.0f,  0,   0,    0 },
+        { "Vocal Leveler",     -24.0f,  3.0f,   3.0f,  200.0f,  6.0f,  6.0f,   0.0f,  1,   0,    0 },
+        { "Gentle Master",      -8.0f,  1.5f,  30.0f,  600.0f,  1.0f, 12.0f,   0.0f,  1,   0,    0 },
+        { "Vintage Feedback",  -16.0f,  4.0f,  10.0f,  300.0f,  3.0f,  6.0f,  25.0f,  0,   1,    0 },
+        { "Multiband Master",  -16.0f,  2.0f,  10.0f,  200.0f,  2.0f,  6.0f,   0.0f,  1,   0,    2 },
+    };
+
+    static constexpr int numPresets = (int) (sizeof (bank) / sizeof (bank[0]));
+};
\ No newline at end of file
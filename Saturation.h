@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+#include "LinkLayout.h"
+
+//==============================================================================
+// Output saturation with first-order antiderivative anti-aliasing (ADAA).
+//
+// The curve is a cubic soft clipper, f (u) = u - u^3 / 3 for |u| <= 1 and
+// +-2/3 beyond, applied as f (g * x) / g: the curve has unity slope at 0 and
+// the drive g only moves the point where it starts to bend. ADAA is applied to
+// the residual r (u) = f (u) - u, the part of the curve that distorts, and the
+// input passes straight through:
+//
+//   y[n] = x[n] + (mean of r over the line from u[n-1] to u[n]) / g,    u = g * x
+//
+// The mean of r is (F (u[n]) - F (u[n-1])) / (u[n] - u[n-1]) - (u[n-1] + u[n]) / 2,
+// with F the antiderivative of f, so it keeps the precision of averaging f
+// itself. The averaging attenuates the harmonics a plain waveshaper folds back
+// from above Nyquist, the more the higher they sit in the band, so the stage
+// needs no oversampling of its own.
+//
+// Only the residual carries the averaging's half-sample delay and its
+// cos (pi f / fs) response; the linear part of the curve is passed at unity
+// without delay or high-frequency loss. Quiet signals, where r is near 0,
+// come out nearly unchanged, and at drive 0 the residual vanishes and the
+// stage is an identity, so it is switched out there without a step.
+//
+// When two samples are too close for the division to be accurate, the residual
+// at their midpoint stands in (the difference is below f'' * du^2 / 24).
+//
+// f and F are both clamped polynomials, so a channel is processed in one
+// branch-free loop. It is written on the SSLFastMath registers: left to
+// itself, GCC turns the clamps into branches and keeps the loop scalar.
+
+// Last input sample per channel, the x[n-1] of the next block.
+template <typename SampleType>
+struct SSLSaturatorState
+{
+    SampleType previous[SSLLinkLayout::maxChannels] {};
+
+    void reset() noexcept      { *this = {}; }
+};
+
+struct SSLSaturator
+{
+    // Drive at 100 %: the curve bends from 1 / maxCurveGain (-6 dBFS) and settles at a third of full scale
+    static constexpr float maxCurveGain = 2.0f;
+
+    static float getCurveGain (float drivePercent) noexcept     { return drivePercent * 0.01f * maxCurveGain; }
+
+    // Saturates one channel in place. curveGain holds g per sample (near 0 the output is
+    // the input), temp is scratch for numSamples values, and previous is the channel's
+    // last input.
+    template <typename SampleType>
+    static void process (SampleType* data, const SampleType* curveGain, SampleType* temp, SampleType& previous, int numSamples) noexcept
+    {
+        using Vector = SSLFastMath::VectorOps<SampleType>;
+        using Scalar = SSLFastMath::ScalarOps<SampleType>;
+
+        if (numSamples <= 0)
+            return;
+
+        // The loop reads x[n-1] after y[n-1] has replaced it, so it works from a copy
+        juce::FloatVectorOperations::copy (temp, data, numSamples);
+
+        data[0] = shape<Scalar> (previous, temp[0], curveGain[0]);
+        int i = 1;
+
+        for (; i + Vector::width <= numSamples; i += Vector::width)
+            Vector::store (data + i, shape<Vector> (Vector::load (temp + i - 1), Vector::load (temp + i), Vector::load (curveGain + i)));
+
+        for (; i < numSamples; ++i)
+            data[i] = shape<Scalar> (temp[i - 1], temp[i], curveGain[i]);
+
+        previous = temp[numSamples - 1];
+    }
+
+private:
+    // Below this |du| the midpoint is used: float loses more to cancellation in F than the
+    // midpoint error from about 5e-3, double only below 1e-5.
+    template <typename SampleType>
+    static constexpr SampleType tolerance = std::is_same_v<SampleType, double> ? (SampleType) 1.0e-5 : (SampleType) 5.0e-3;
+
+    template <typename Ops>
+    static typename Ops::Float shape (typename Ops::Float x0, typename Ops::Float x1, typename Ops::Float g) noexcept
+    {
+        using Sample = typename Ops::Sample;
+
+        g = Ops::max (g, Ops::splat ((Sample) 1.0e-6));
+
+        const auto u0 = Ops::mul (g, x0);
+        const auto u1 = Ops::mul (g, x1);
+        const auto du = Ops::sub (u1, u0);
+        const auto accurate = Ops::isGreater (Ops::abs (du), Ops::splat (tolerance<Sample>));
+
+        // Both are computed and blended, the division by 1 where du is too small to divide by
+        const auto one = Ops::splat ((Sample) 1);
+        const auto half = Ops::splat ((Sample) 0.5);
+        const auto linear = Ops::mul (half, Ops::add (u0, u1));
+        const auto mean = Ops::div (Ops::sub (antiderivative<Ops> (u1), antiderivative<Ops> (u0)), Ops::add (du, Ops::sub (one, accurate)));
+        const auto midpoint = curve<Ops> (linear);
+        const auto residual = Ops::sub (Ops::add (midpoint, Ops::mul (accurate, Ops::sub (mean, midpoint))), linear);
+
+        return Ops::add (x1, Ops::div (residual, g));
+    }
+
+    template <typename Ops>
+    static typename Ops::Float curve (typename Ops::Float u) noexcept
+    {
+        using Sample = typename Ops::Sample;
+
+        const auto c = Ops::min (Ops::max (u, Ops::splat ((Sample) -1)), Ops::splat ((Sample) 1));
+        return Ops::sub (c, Ops::mul (Ops::mul (c, Ops::mul (c, c)), Ops::splat ((Sample) (1.0 / 3.0))));
+    }
+
+    // u^2 / 2 - u^4 / 12 inside the knee, continued linearly with slope 2/3 beyond it
+    template <typename Ops>
+    static typename Ops::Float antiderivative (typename Ops::Float u) noexcept
+    {
+        using Sample = typename Ops::Sample;
+
+        const auto magnitude = Ops::abs (u);
+        const auto a = Ops::min (magnitude, Ops::splat ((Sample) 1));
+        const auto a2 = Ops::mul (a, a);
+        const auto inside = Ops::mul (a2, Ops::sub (Ops::splat ((Sample) 0.5), Ops::mul (a2, Ops::splat ((Sample) (1.0 / 12.0)))));
+
+        return Ops::add (inside, Ops::mul (Ops::sub (magnitude, a), Ops::splat ((Sample) (2.0 / 3.0))));
+    }
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#!/bin/sh
+# Writes Benchmark's references from the original processor: the golden renders
+# for the configurations it could render, and benchmark_baseline.txt with its
+# timings. GoldenReference.cpp and Benchmark.h are built against the sources of
+# the repository's first commit (or $SSL_BASELINE_COMMIT) in a temporary
+# worktree; this tree is not touched apart from the outputs.
+#
+#   ./golden_baseline.sh <JUCE source dir> [golden dir] [baseline file]
+#
+# Run Benchmark without --update-baseline afterwards to compare against them.
+
+set -e
+
+if [ $# -lt 1 ]; then
+    echo "usage: $0 <JUCE source dir> [golden dir] [baseline file]" >&2
+    exit 1
+fi
+
+absolute() {
+    case "$1" in
+        /*) echo "$1" ;;
+        *) echo "$(pwd)/$1" ;;
+    esac
+}
+
+juce=$(absolute "$1")
+golden=$(absolute "${2:-golden}")
+baseline=$(absolute "${3:-benchmark_baseline.txt}")
+
+repo=$(git rev-parse --show-toplevel)
+commit=${SSL_BASELINE_COMMIT:-$(git -C "$repo" rev-list --max-parents=0 HEAD | tail -n 1)}
+work=$(mktemp -d)
+
+cleanup() {
+    git -C "$repo" worktree remove --force "$work/src" 2>/dev/null || true
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+git -C "$repo" worktree add --detach "$work/src" "$commit" >/dev/null
+cp "$repo/GoldenReference.cpp" "$repo/Benchmark.h" "$work/src/"
+
+# The baseline's PluginEditor.cpp doesn't compile, so only PluginProcessor.cpp
+# is built. Its createEditor returns a GenericAudioProcessorEditor and needs no
+# more than the declarations in PluginEditor.h; the plugin entry point comes
+# from this stub.
+cat > "$work/src/GoldenStubs.cpp" <<'STUB'
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new SSLCompressorAudioProcessor();
+}
+STUB
+
+cat > "$work/CMakeLists.txt" <<EOF
+cmake_minimum_required (VERSION 3.22)
+project (SSLGoldenReference)
+
+add_subdirectory ("$juce" juce)
+
+juce_add_console_app (GoldenReference PRODUCT_NAME "GoldenReference")
+juce_generate_juce_header (GoldenReference)
+
+target_sources (GoldenReference PRIVATE
+    "$work/src/GoldenReference.cpp"
+    "$work/src/PluginProcessor.cpp"
+    "$work/src/GoldenStubs.cpp")
+
+target_compile_definitions (GoldenReference PRIVATE
+    "JucePlugin_Name=\"SSL Compressor\""
+    JUCE_WEB_BROWSER=0
+    JUCE_USE_CURL=0)
+
+target_link_libraries (GoldenReference PRIVATE
+    juce::juce_audio_utils
+    juce::juce_dsp)
+EOF
+
+cmake -S "$work" -B "$work/build" -DCMAKE_BUILD_TYPE=Release >/dev/null
+cmake --build "$work/build" --config Release --parallel
+
+exe=$(find "$work/build" -type f \( -name GoldenReference -o -name GoldenReference.exe \) | head -n 1)
+"$exe" --golden "$golden" --baseline "$baseline"